@@ -0,0 +1,374 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "stylememoryusage.hpp"
+
+#include "control.hpp"
+#include "padding.hpp"
+
+#include "api/internal/style/abstractstyledispatcher.hpp"
+#include "api/internal/style/style.hpp"
+#include "api/internal/style/stylefactory.hpp"
+#include "api/internal/style/stylepropertychanges.hpp"
+#include "api/internal/style/stylepropertyexpression.hpp"
+#include "api/internal/style/stylestate.hpp"
+#include "api/internal/style/stylestatecontroller.hpp"
+#include "api/internal/style/stylestateoperation.hpp"
+
+#include "api/private/control_p.hpp"
+#include "api/private/style/style_p.hpp"
+#include "api/private/style/stylepropertychanges_p.hpp"
+#include "api/private/style/stylestate_p.hpp"
+
+#include <QtCore/QMap>
+#include <QtCore/QSet>
+#include <QtCore/QVarLengthArray>
+
+#include <QtCore/private/qobject_p.h>
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+namespace {
+
+using MappingNode = QMapNode<const Control *, QQuickItem *>;
+
+// the heap footprints below are estimates: they account for the payload and the bookkeeping of the
+// Qt containers, but not for the overhead of the memory allocator.
+
+qint64 sizeOf(const QString &string)
+{
+    if (string.isNull())
+        return 0;
+
+    return sizeof(QArrayData) + (string.capacity() + 1) * sizeof(QChar);
+}
+
+qint64 sizeOf(const QVariant &variant)
+{
+    if (variant.userType() == QMetaType::QString)
+        return sizeOf(variant.toString());
+
+    const int size = QMetaType::sizeOf(variant.userType());
+
+    // the small types are stored in the variant itself, the others in a shared block.
+    return size > static_cast<int>(sizeof(double)) ? size + sizeof(void *) + sizeof(QAtomicInt) : 0;
+}
+
+template<typename T>
+qint64 sizeOf(const QVector<T> &vector)
+{
+    return vector.capacity() > 0 ? sizeof(QArrayData) + vector.capacity() * sizeof(T) : 0;
+}
+
+template<typename T>
+qint64 sizeOf(const QList<T> &list)
+{
+    return list.isEmpty() ? 0 : sizeof(QListData::Data) + list.count() * sizeof(void *);
+}
+
+template<typename T, int Prealloc>
+qint64 sizeOf(const QVarLengthArray<T, Prealloc> &array)
+{
+    // up to Prealloc items are stored within the array itself.
+    return array.capacity() > Prealloc ? array.capacity() * sizeof(T) : 0;
+}
+
+template<typename K, typename V>
+qint64 sizeOf(const QHash<K, V> &hash)
+{
+    if (hash.capacity() == 0)
+        return 0;
+
+    return sizeof(QHashData) + hash.capacity() * sizeof(void *)
+            + hash.count() * sizeof(QHashNode<K, V>);
+}
+
+qint64 sizeOfMappings(const StylePropertyExpression &expression)
+{
+    const auto mappings = expression.count().first;
+    return mappings > 0 ? sizeof(QMapDataBase) + mappings * sizeof(MappingNode) : 0;
+}
+
+qint64 sizeOf(const StylePropertyExpression &expression)
+{
+    qint64 result = sizeof(StylePropertyExpression);
+
+    const auto &properties = expression.properties();
+    result += sizeOf(properties);
+
+    // the values are interned in the constant pool of StyleValue and are not owned by the
+    // expression.
+    for (const auto &property : properties)
+    {
+        result += sizeOf(property.first);
+    }
+
+    return result;
+}
+
+qint64 sizeOf(const StylePropertyChanges *changes)
+{
+    const auto *const d = StylePropertyChangesPrivate::get(changes);
+    qint64 result = sizeof(StylePropertyChanges) + sizeof(StylePropertyChangesPrivate);
+
+    for (const auto *properties : {&d->properties, &d->defaultProperties})
+    {
+        result += sizeOf(*properties);
+
+        for (const auto &property : *properties)
+        {
+            result += sizeOf(property.first) + sizeOf(property.second);
+        }
+    }
+
+    return result;
+}
+
+qint64 sizeOf(const StyleState *state)
+{
+    const auto *const d = StyleStatePrivate::get(state);
+    qint64 result = sizeof(StyleState) + sizeof(StyleStatePrivate) + sizeOf(d->name)
+            + sizeOf(d->changes);
+
+    for (const auto *changes : d->changes)
+    {
+        result += sizeOf(changes);
+    }
+
+    return result;
+}
+
+qint64 sizeOf(const Style *style)
+{
+    const auto *const d = StylePrivate::get(style);
+    qint64 result = sizeof(Style) + sizeof(StylePrivate) + sizeOf(d->name) + sizeOf(d->states);
+
+    for (const auto *state : d->states)
+    {
+        result += sizeOf(state);
+    }
+
+    return result;
+}
+
+} // namespace
+
+
+/*! \class StyleMemoryUsage
+    \since StoiridhControlsTemplates 1.0
+    \ingroup diagnostics
+
+    \brief The StyleMemoryUsage class estimates the heap footprint of the styles and controls.
+
+    The footprint of a style registered in the StyleFactory is split into:
+
+    \list
+        \li \c style: the Style object tree, i.e., the style, its states and their property
+            changes.
+        \li \c operations: the StyleStateController and its StyleStateOperation.
+        \li \c expressions: the properties stored by the StylePropertyExpression.
+        \li \c mappings: the mappings of the controls to their targets.
+        \li \c writers: the property indexes resolved by the StylePropertyExpression for the
+            types of the targets.
+    \endlist
+
+    The footprints are estimated from the size of the objects and the bookkeeping of the Qt
+    containers; the overhead of the memory allocator is not accounted for. They are exposed to QML
+    through the StyleStatistics singleton.
+*/
+
+
+/*!
+    Returns the total footprint, in bytes.
+*/
+qint64 StyleMemoryUsage::Footprint::total() const noexcept
+{
+    return style + operations + expressions + mappings + writers;
+}
+
+/*!
+    Returns the footprint as a QVariantMap, e.g., in order to be used from QML.
+*/
+QVariantMap StyleMemoryUsage::Footprint::toVariantMap() const
+{
+    return QVariantMap{
+        {QStringLiteral("style"), static_cast<double>(style)},
+        {QStringLiteral("operations"), static_cast<double>(operations)},
+        {QStringLiteral("expressions"), static_cast<double>(expressions)},
+        {QStringLiteral("mappings"), static_cast<double>(mappings)},
+        {QStringLiteral("writers"), static_cast<double>(writers)},
+        {QStringLiteral("controls"), controls},
+        {QStringLiteral("total"), static_cast<double>(total())}
+    };
+}
+
+/*!
+    Returns the estimated footprint of the style of the \a dispatcher.
+*/
+StyleMemoryUsage::Footprint StyleMemoryUsage::estimate(const AbstractStyleDispatcher *dispatcher)
+{
+    Footprint footprint{};
+
+    if (!dispatcher || !dispatcher->style())
+        return footprint;
+
+    const auto *const style = dispatcher->style();
+    footprint.style = sizeOf(style);
+
+    const auto *const d_style = StylePrivate::get(style);
+    auto *const controller = d_style->stateController();
+
+    if (!controller)
+        return footprint;
+
+    QSet<const Control *> controls{};
+    QSet<const StylePropertyExpression *> expressions{};
+
+    footprint.operations = sizeof(StyleStateController);
+
+    for (auto cit = controller->cbegin(); cit != controller->cend(); ++cit)
+    {
+        const auto &operation = cit->second;
+
+        footprint.operations += sizeof(QPair<QString, StyleStateOperation *>)
+                + sizeOf(cit->first) + sizeof(StyleStateOperation)
+                + sizeOf(operation->name());
+
+        if (operation->count() > 0)
+        {
+            footprint.operations += sizeof(QArrayData)
+                    + operation->count() * sizeof(StylePropertyExpression *);
+        }
+
+        for (auto eit = operation->cbegin(); eit != operation->cend(); ++eit)
+        {
+            const auto &expression = *eit;
+
+            // an expression shared by several operations is allocated only once.
+            if (expressions.contains(expression))
+                continue;
+
+            expressions.insert(expression);
+
+            footprint.expressions += sizeOf(*expression);
+            footprint.mappings += sizeOfMappings(*expression);
+            footprint.writers += sizeOfWriters(*expression);
+
+            for (const auto *control : expression->controls())
+            {
+                controls.insert(control);
+            }
+        }
+    }
+
+    footprint.controls = controls.count();
+
+    return footprint;
+}
+
+/*!
+    Returns the estimated footprint of each style registered in the StyleFactory for the QML
+    \a engine, by control's signature.
+*/
+QHash<QString, StyleMemoryUsage::Footprint>
+StyleMemoryUsage::estimateFactory(const QQmlEngine *engine)
+{
+    QHash<QString, Footprint> result{};
+
+    const auto dispatchers = StyleFactory::dispatchers(engine);
+
+    for (auto cit = dispatchers.cbegin(); cit != dispatchers.cend(); ++cit)
+    {
+        result.insert(cit.key(), estimate(cit.value()));
+    }
+
+    return result;
+}
+
+/*!
+    Returns the estimated footprint of the \a control, in bytes.
+
+    The footprint includes the control, its private data and padding, as well as its share of the
+    mappings of its style. The background and content items are not included.
+*/
+qint64 StyleMemoryUsage::estimate(const Control *control)
+{
+    if (!control)
+        return 0;
+
+    const auto *const d = ControlPrivate::get(control);
+    qint64 result = sizeof(Control) + sizeof(ControlPrivate) + sizeOf(d->styleState());
+
+    if (d->padding)
+        result += sizeof(Padding) + sizeof(QObjectPrivate);
+
+    if (auto *const style = d->style())
+    {
+        if (auto *const controller = StylePrivate::get(style)->stateController())
+        {
+            for (auto cit = controller->cbegin(); cit != controller->cend(); ++cit)
+            {
+                const auto &operation = cit->second;
+
+                for (auto eit = operation->cbegin(); eit != operation->cend(); ++eit)
+                {
+                    if ((*eit)->containsControl(control))
+                        result += sizeof(MappingNode);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+/*!
+    \internal
+
+    Returns the estimated footprint of the property indexes cached by the \a expression for the
+    types of its targets.
+*/
+qint64 StyleMemoryUsage::sizeOfWriters(const StylePropertyExpression &expression)
+{
+    qint64 result = sizeOf(expression.m_propertyIndexes);
+
+    for (const auto &indexes : expression.m_propertyIndexes)
+    {
+        result += sizeOf(indexes);
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////   DOCUMENTATION    ////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class StyleMemoryUsage::Footprint
+    \since StoiridhControlsTemplates 1.0
+    \ingroup diagnostics
+
+    \brief The StyleMemoryUsage::Footprint structure holds the estimated heap footprint of a style,
+           in bytes.
+*/
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLEMEMORYUSAGE_HPP
+#define STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLEMEMORYUSAGE_HPP
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  --------------------------------------------------------------------------------------------  //
+//  /!\                                     W A R N I N G                                    /!\  //
+//  --------------------------------------------------------------------------------------------  //
+//                                                                                                //
+//  This internal header file is not part of StoiridhControlsTemplates API. It exists purely as   //
+//  an internal use and must not be used in external project(s).                                  //
+//                                                                                                //
+//  The content of this file may change from version to version without notice, or even be        //
+//  removed.                                                                                      //
+//                                                                                                //
+//  You are forewarned!                                                                           //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "api/internal/global.hpp"
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+
+QT_BEGIN_NAMESPACE
+class QQmlEngine;
+QT_END_NAMESPACE
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+class AbstractStyleDispatcher;
+class Control;
+class StylePropertyExpression;
+
+class SCT_INTERNAL_API StyleMemoryUsage final
+{
+public:
+    struct Footprint
+    {
+        qint64 style{};
+        qint64 operations{};
+        qint64 expressions{};
+        qint64 mappings{};
+        qint64 writers{};
+        int controls{};
+
+        qint64 total() const noexcept;
+        QVariantMap toVariantMap() const;
+    };
+
+public:
+    StyleMemoryUsage() = delete;
+
+    static Footprint estimate(const AbstractStyleDispatcher *dispatcher);
+    static QHash<QString, Footprint> estimateFactory(const QQmlEngine *engine);
+    static qint64 estimate(const Control *control);
+
+private:
+    static qint64 sizeOfWriters(const StylePropertyExpression &expression);
+};
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
+
+#endif // STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLEMEMORYUSAGE_HPP
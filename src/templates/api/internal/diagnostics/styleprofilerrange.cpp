@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "styleprofilerrange.hpp"
+
+#include <QtQml/QQmlContext>
+#include <QtQml/QQmlEngine>
+#include <QtQml/qqml.h>
+
+#include <QtQml/private/qqmldata_p.h>
+#include <QtQml/private/qqmlengine_p.h>
+#include <QtQml/private/qqmlmetatype_p.h>
+#include <QtQml/private/qqmlprofiler_p.h>
+
+#ifndef QT_NO_QML_DEBUGGER
+#include <QtQml/private/qqmldebugconnector_p.h>
+#endif
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+
+/*! \class StyleProfilerRange
+    \since StoiridhControlsTemplates 1.0
+    \ingroup diagnostics
+
+    \brief The StyleProfilerRange class reports a range of style work to the QML profiler.
+
+    A style profiler range emits a \e Creating range to the QML profiler of the engine of an object
+    during its lifetime, so that the style work appears with its own details in the timeline of the
+    QML profiler instead of being merged within \c componentComplete or a signal handler.
+
+    The detail of a range is given as a callable returning a QString, it is only invoked when the
+    QML profiler records the creation ranges. Thus, when the profiler is off, a range costs a null
+    pointer check.
+
+    Example:
+
+    \code
+    StyleProfilerRange range{control, [control]() {
+        return QStringLiteral("StyleFactory::create %1").arg(StyleProfilerRange::typeName(control));
+    }};
+    \endcode
+*/
+
+
+/*!
+    \fn StyleProfilerRange::StyleProfilerRange(const QObject *object, Detail &&detail)
+
+    Starts a range for the \a object with the given \a detail.
+*/
+
+/*!
+    Ends the range.
+*/
+StyleProfilerRange::~StyleProfilerRange()
+{
+#ifndef QT_NO_QML_DEBUGGER
+    if (Q_UNLIKELY(m_profiler))
+        m_profiler->endRange<QQmlProfilerDefinitions::Creating>();
+#endif
+}
+
+/*!
+    \fn bool StyleProfilerRange::isActive() const noexcept
+
+    Returns true if the range is recorded by the QML profiler, otherwise, false.
+*/
+
+/*!
+    \fn void StyleProfilerRange::update(Detail &&detail)
+
+    Updates the \a detail of the range, e.g., with the number of property writes once known.
+*/
+
+/*!
+    Returns the QML type name of the \a object or its class name if the \a object has not a QML
+    type.
+*/
+QString StyleProfilerRange::typeName(const QObject *object)
+{
+    if (!object)
+        return {};
+
+    const auto *const metaObject = object->metaObject();
+
+    if (auto *const qmlType = QQmlMetaType::qmlType(metaObject))
+        return qmlType->qmlTypeName();
+
+    return QString::fromUtf8(metaObject->className());
+}
+
+/*!
+    \internal
+
+    Returns the QML profiler of the engine of the \a object if it records the creation ranges,
+    otherwise, nullptr.
+*/
+QQmlProfiler *StyleProfilerRange::profiler(const QObject *object)
+{
+#ifndef QT_NO_QML_DEBUGGER
+    // without a debug connector (-qmljsdebugger), there is not QML profiler at all.
+    if (Q_LIKELY(!QQmlDebugConnector::instance()) || !object)
+        return nullptr;
+
+    auto *const engine = QtQml::qmlEngine(object);
+
+    if (!engine)
+        return nullptr;
+
+    auto *const profiler = QQmlEnginePrivate::get(engine)->profiler;
+
+    if (profiler && (profiler->featuresEnabled & (1 << QQmlProfilerDefinitions::ProfileCreating)))
+        return profiler;
+#else
+    Q_UNUSED(object);
+#endif
+
+    return nullptr;
+}
+
+/*!
+    \internal
+
+    Starts the range with the location of the \a object and the given \a detail.
+*/
+void StyleProfilerRange::start(const QObject *object, const QString &detail)
+{
+#ifndef QT_NO_QML_DEBUGGER
+    if (auto *const context = QtQml::qmlContext(object))
+        m_url = context->baseUrl();
+
+    if (auto *const data = QQmlData::get(object))
+    {
+        m_line = data->lineNumber;
+        m_column = data->columnNumber;
+    }
+
+    m_profiler->startCreating(detail, m_url, m_line, m_column);
+#else
+    Q_UNUSED(object);
+    Q_UNUSED(detail);
+#endif
+}
+
+/*!
+    \internal
+
+    Updates the \a detail of the range.
+*/
+void StyleProfilerRange::updateDetail(const QString &detail)
+{
+#ifndef QT_NO_QML_DEBUGGER
+    m_profiler->updateCreating(detail, m_url, m_line, m_column);
+#else
+    Q_UNUSED(detail);
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
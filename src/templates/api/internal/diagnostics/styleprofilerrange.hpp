@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLEPROFILERRANGE_HPP
+#define STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLEPROFILERRANGE_HPP
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  --------------------------------------------------------------------------------------------  //
+//  /!\                                     W A R N I N G                                    /!\  //
+//  --------------------------------------------------------------------------------------------  //
+//                                                                                                //
+//  This internal header file is not part of StoiridhControlsTemplates API. It exists purely as   //
+//  an internal use and must not be used in external project(s).                                  //
+//                                                                                                //
+//  The content of this file may change from version to version without notice, or even be        //
+//  removed.                                                                                      //
+//                                                                                                //
+//  You are forewarned!                                                                           //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "api/internal/global.hpp"
+
+#include <QtCore/QString>
+#include <QtCore/QUrl>
+
+QT_BEGIN_NAMESPACE
+class QObject;
+class QQmlProfiler;
+QT_END_NAMESPACE
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+class SCT_INTERNAL_API StyleProfilerRange final
+{
+public:
+    template<typename Detail>
+    StyleProfilerRange(const QObject *object, Detail &&detail);
+    StyleProfilerRange(const StyleProfilerRange &rhs) = delete;
+    StyleProfilerRange(StyleProfilerRange &&rhs) = delete;
+    ~StyleProfilerRange();
+
+    bool isActive() const noexcept;
+
+    template<typename Detail>
+    void update(Detail &&detail);
+
+    static QString typeName(const QObject *object);
+
+    StyleProfilerRange &operator=(const StyleProfilerRange &rhs) = delete;
+    StyleProfilerRange &operator=(StyleProfilerRange &&rhs) = delete;
+
+private:
+    static QQmlProfiler *profiler(const QObject *object);
+
+    void start(const QObject *object, const QString &detail);
+    void updateDetail(const QString &detail);
+
+private:
+    QQmlProfiler *m_profiler{nullptr};
+    QUrl m_url{};
+    int m_line{};
+    int m_column{};
+};
+
+//--------------------------------------------------------------------------------------------------
+
+template<typename Detail>
+inline StyleProfilerRange::StyleProfilerRange(const QObject *object, Detail &&detail)
+    : m_profiler{profiler(object)}
+{
+    // the detail is only built when the QML profiler records the creation ranges.
+    if (Q_UNLIKELY(m_profiler))
+        start(object, detail());
+}
+
+inline bool StyleProfilerRange::isActive() const noexcept
+{
+    return m_profiler != nullptr;
+}
+
+template<typename Detail>
+inline void StyleProfilerRange::update(Detail &&detail)
+{
+    if (Q_UNLIKELY(m_profiler))
+        updateDetail(detail());
+}
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
+
+#endif // STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLEPROFILERRANGE_HPP
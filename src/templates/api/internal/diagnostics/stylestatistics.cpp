@@ -0,0 +1,444 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "stylestatistics.hpp"
+
+#include "control.hpp"
+
+#include "api/internal/diagnostics/stylememoryusage.hpp"
+#include "api/internal/style/abstractstyledispatcher.hpp"
+#include "api/internal/style/style.hpp"
+#include "api/internal/style/stylefactory.hpp"
+#include "api/internal/style/stylestatecontroller.hpp"
+
+#include "api/private/style/style_p.hpp"
+
+#include <QtCore/QSet>
+#include <QtCore/QTimerEvent>
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+StyleStatistics::Counter StyleStatistics::m_dispatches{0};
+StyleStatistics::Counter StyleStatistics::m_writes{0};
+StyleStatistics::Counter StyleStatistics::m_failedWrites{0};
+StyleStatistics::Counter StyleStatistics::m_failedMappings{0};
+
+
+/*! \class StyleStatistics
+    \since StoiridhControlsTemplates 1.0
+    \ingroup diagnostics
+
+    \brief The StyleStatistics class exposes live counters of the style factory and dispatchers.
+
+    The StyleStatistics class is registered as a QML singleton in order to be displayed, e.g., on
+    an overlay of a production build:
+
+    \code
+    import Stoiridh.Controls.Private 1.0
+
+    Text {
+        text: StyleStatistics.dispatchesPerSecond + " dispatches/s, "
+              + StyleStatistics.failedWriteCount + " failed writes"
+    }
+    \endcode
+
+    The dispatch counters are process-wide and updated with relaxed atomic operations from the
+    dispatch path. They are refreshed, with the number of style dispatchers, every updateInterval
+    milliseconds.
+
+    The structural statistics (mapped controls, states and expressions) walk every expression of
+    every style registered in the StyleFactory for the QML engine of the singleton, so they are
+    only computed when update() is called:
+
+    \code
+    MouseArea {
+        anchors.fill: parent
+        onClicked: StyleStatistics.update()
+    }
+    \endcode
+
+    When the library is built with \c SCT_NO_STYLE_STATISTICS defined, the recording methods compile
+    to no-ops, the enabled property is \c false and the statistics are only updated on demand with
+    update().
+*/
+
+
+/*!
+    Constructs a style statistics with the given \a parent.
+*/
+StyleStatistics::StyleStatistics(QObject *parent)
+    : QObject{parent}
+{
+    m_lastDispatches = m_dispatches.load();
+    m_lastWrites = m_writes.load();
+    m_elapsedTimer.start();
+
+    // the counters are only updated periodically when the statistics are recorded.
+    if (isEnabled())
+        m_timer.start(m_updateInterval, this);
+}
+
+/*!
+    Returns a new style statistics for the QML \a engine.
+*/
+QObject *StyleStatistics::qmlSingleton(QQmlEngine *engine, QJSEngine *scriptEngine)
+{
+    Q_UNUSED(scriptEngine);
+
+    auto *const statistics = new StyleStatistics{};
+    statistics->m_engine = engine;
+    statistics->update();
+
+    return statistics;
+}
+
+/*! \property bool StyleStatistics::enabled
+    \readonly
+
+    This property holds whether the statistics are recorded. It is \c false when the library is
+    built with \c SCT_NO_STYLE_STATISTICS.
+*/
+
+/*! \property int StyleStatistics::updateInterval
+
+    This property holds the interval, in milliseconds, between two updates of the statistics.
+
+    The default value is 1000 milliseconds.
+*/
+int StyleStatistics::updateInterval() const noexcept
+{
+    return m_updateInterval;
+}
+
+void StyleStatistics::setUpdateInterval(int msecs)
+{
+    msecs = qMax(1, msecs);
+
+    if (m_updateInterval != msecs)
+    {
+        m_updateInterval = msecs;
+
+        if (isEnabled())
+            m_timer.start(m_updateInterval, this);
+
+        emit updateIntervalChanged();
+    }
+}
+
+/*! \property int StyleStatistics::dispatcherCount
+    \readonly
+
+    This property holds the number of style dispatchers registered in the StyleFactory.
+*/
+int StyleStatistics::dispatcherCount() const noexcept
+{
+    return m_dispatcherCount;
+}
+
+/*! \property QVariantMap StyleStatistics::mappedControls
+    \readonly
+
+    This property holds the number of controls mapped to a style by control's signature.
+
+    \note This property is only computed by update().
+*/
+QVariantMap StyleStatistics::mappedControls() const
+{
+    return m_mappedControls;
+}
+
+/*! \property QVariantMap StyleStatistics::statesPerStyle
+    \readonly
+
+    This property holds the number of style's states by control's signature.
+
+    \note This property is only computed by update().
+*/
+QVariantMap StyleStatistics::statesPerStyle() const
+{
+    return m_statesPerStyle;
+}
+
+/*! \property int StyleStatistics::expressionCount
+    \readonly
+
+    This property holds the total number of style property expressions. An expression shared by
+    several style state operations is counted once.
+
+    \note This property is only computed by update().
+*/
+int StyleStatistics::expressionCount() const noexcept
+{
+    return m_expressionCount;
+}
+
+/*! \property double StyleStatistics::dispatchCount
+    \readonly
+
+    This property holds the total number of dispatches.
+*/
+double StyleStatistics::dispatchCount() const noexcept
+{
+    return static_cast<double>(m_dispatches.load());
+}
+
+/*! \property double StyleStatistics::writeCount
+    \readonly
+
+    This property holds the total number of property writes.
+*/
+double StyleStatistics::writeCount() const noexcept
+{
+    return static_cast<double>(m_writes.load());
+}
+
+/*! \property double StyleStatistics::dispatchesPerSecond
+    \readonly
+
+    This property holds the number of dispatches per second since the last update.
+*/
+double StyleStatistics::dispatchesPerSecond() const noexcept
+{
+    return m_dispatchesPerSecond;
+}
+
+/*! \property double StyleStatistics::writesPerSecond
+    \readonly
+
+    This property holds the number of property writes per second since the last update.
+*/
+double StyleStatistics::writesPerSecond() const noexcept
+{
+    return m_writesPerSecond;
+}
+
+/*! \property double StyleStatistics::failedWriteCount
+    \readonly
+
+    This property holds the total number of property writes that have failed because the property
+    was either invalid or read-only.
+*/
+double StyleStatistics::failedWriteCount() const noexcept
+{
+    return static_cast<double>(m_failedWrites.load());
+}
+
+/*! \property double StyleStatistics::failedMappingCount
+    \readonly
+
+    This property holds the total number of controls that could not be mapped to the style of
+    their signature.
+*/
+double StyleStatistics::failedMappingCount() const noexcept
+{
+    return static_cast<double>(m_failedMappings.load());
+}
+
+/*!
+    Updates all the statistics, including the structural statistics.
+
+    \note Only the counters are automatically updated every updateInterval milliseconds.
+*/
+void StyleStatistics::update()
+{
+    m_mappedControls.clear();
+    m_statesPerStyle.clear();
+    m_expressionCount = 0;
+
+    const auto dispatchers = StyleFactory::dispatchers(m_engine);
+
+    for (auto it = dispatchers.cbegin(); it != dispatchers.cend(); ++it)
+    {
+        auto *const style = it.value()->style();
+
+        if (!style)
+            continue;
+
+        auto *const d_style = StylePrivate::get(style);
+        m_statesPerStyle.insert(it.key(), d_style->states.count());
+
+        QSet<const Control *> controls{};
+        QSet<const StylePropertyExpression *> expressions{};
+
+        if (auto *const controller = d_style->stateController())
+        {
+            for (auto cit = controller->cbegin(); cit != controller->cend(); ++cit)
+            {
+                const auto &operation = cit->second;
+
+                for (auto eit = operation->cbegin(); eit != operation->cend(); ++eit)
+                {
+                    if (expressions.contains(*eit))
+                        continue;
+
+                    expressions.insert(*eit);
+                    ++m_expressionCount;
+
+                    for (const auto *control : (*eit)->controls())
+                    {
+                        controls.insert(control);
+                    }
+                }
+            }
+        }
+
+        m_mappedControls.insert(it.key(), controls.count());
+    }
+
+    updateCounters();
+}
+
+/*!
+    \internal
+
+    Updates the dispatch counters, their rates and the number of style dispatchers.
+*/
+void StyleStatistics::updateCounters()
+{
+    m_dispatcherCount = StyleFactory::dispatchers(m_engine).count();
+
+    // rates since the last update
+    const auto elapsed = m_elapsedTimer.restart();
+    const quint64 dispatches = m_dispatches.load();
+    const quint64 writes = m_writes.load();
+
+    if (elapsed > 0)
+    {
+        m_dispatchesPerSecond = (dispatches - m_lastDispatches) * 1000.0 / elapsed;
+        m_writesPerSecond = (writes - m_lastWrites) * 1000.0 / elapsed;
+    }
+
+    m_lastDispatches = dispatches;
+    m_lastWrites = writes;
+
+    emit statisticsChanged();
+}
+
+/*!
+    Resets the dispatch counters to zero.
+*/
+void StyleStatistics::reset()
+{
+    m_dispatches.store(0);
+    m_writes.store(0);
+    m_failedWrites.store(0);
+    m_failedMappings.store(0);
+
+    m_lastDispatches = 0;
+    m_lastWrites = 0;
+
+    update();
+}
+
+/*!
+    Returns the estimated heap footprint, in bytes, of each style registered in the StyleFactory by
+    control's signature.
+
+    Each footprint is a map holding the \c style, \c operations, \c expressions, \c mappings,
+    \c writers and \c total footprints, as well as the number of mapped \c controls:
+
+    \code
+    const usage = StyleStatistics.memoryUsage()
+
+    for (var id in usage)
+        console.log(id, usage[id].total)
+    \endcode
+
+    \sa StyleMemoryUsage
+*/
+QVariantMap StyleStatistics::memoryUsage() const
+{
+    QVariantMap result{};
+
+    const auto footprints = StyleMemoryUsage::estimateFactory(m_engine);
+
+    for (auto cit = footprints.cbegin(); cit != footprints.cend(); ++cit)
+    {
+        result.insert(cit.key(), cit.value().toVariantMap());
+    }
+
+    return result;
+}
+
+/*!
+    Returns the estimated heap footprint, in bytes, of the control \a item, or 0 if \a item is not
+    a control.
+
+    \sa StyleMemoryUsage
+*/
+double StyleStatistics::controlMemoryUsage(QQuickItem *item) const
+{
+    return static_cast<double>(StyleMemoryUsage::estimate(qobject_cast<Control *>(item)));
+}
+
+/*! \reimp */
+void StyleStatistics::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_timer.timerId())
+    {
+        updateCounters();
+        return;
+    }
+
+    QObject::timerEvent(event);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////   DOCUMENTATION    ////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \fn bool StyleStatistics::isEnabled() noexcept
+
+    Returns true if the statistics are recorded, otherwise, false.
+*/
+
+/*! \fn void StyleStatistics::recordDispatch() noexcept
+
+    Records a dispatch.
+*/
+
+/*! \fn void StyleStatistics::recordWrites(int writes) noexcept
+
+    Records the number of property \a writes of a dispatch.
+*/
+
+/*! \fn void StyleStatistics::recordFailedWrite() noexcept
+
+    Records a property write that has failed.
+*/
+
+/*! \fn void StyleStatistics::recordFailedMapping() noexcept
+
+    Records a control that could not be mapped.
+*/
+
+/*! \fn void StyleStatistics::statisticsChanged()
+
+    This signal is emitted when the statistics are updated.
+*/
+
+/*! \fn void StyleStatistics::updateIntervalChanged()
+
+    This signal is emitted when the update interval changes.
+*/
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLESTATISTICS_HPP
+#define STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLESTATISTICS_HPP
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  --------------------------------------------------------------------------------------------  //
+//  /!\                                     W A R N I N G                                    /!\  //
+//  --------------------------------------------------------------------------------------------  //
+//                                                                                                //
+//  This internal header file is not part of StoiridhControlsTemplates API. It exists purely as   //
+//  an internal use and must not be used in external project(s).                                  //
+//                                                                                                //
+//  The content of this file may change from version to version without notice, or even be        //
+//  removed.                                                                                      //
+//                                                                                                //
+//  You are forewarned!                                                                           //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "api/internal/global.hpp"
+
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QBasicTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QVariantMap>
+
+QT_BEGIN_NAMESPACE
+class QJSEngine;
+class QQmlEngine;
+class QQuickItem;
+QT_END_NAMESPACE
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+class SCT_INTERNAL_API StyleStatistics : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool enabled READ isEnabled CONSTANT FINAL)
+    Q_PROPERTY(int updateInterval READ updateInterval WRITE setUpdateInterval NOTIFY updateIntervalChanged FINAL)
+    Q_PROPERTY(int dispatcherCount READ dispatcherCount NOTIFY statisticsChanged FINAL)
+    Q_PROPERTY(QVariantMap mappedControls READ mappedControls NOTIFY statisticsChanged FINAL)
+    Q_PROPERTY(QVariantMap statesPerStyle READ statesPerStyle NOTIFY statisticsChanged FINAL)
+    Q_PROPERTY(int expressionCount READ expressionCount NOTIFY statisticsChanged FINAL)
+    Q_PROPERTY(double dispatchCount READ dispatchCount NOTIFY statisticsChanged FINAL)
+    Q_PROPERTY(double writeCount READ writeCount NOTIFY statisticsChanged FINAL)
+    Q_PROPERTY(double dispatchesPerSecond READ dispatchesPerSecond NOTIFY statisticsChanged FINAL)
+    Q_PROPERTY(double writesPerSecond READ writesPerSecond NOTIFY statisticsChanged FINAL)
+    Q_PROPERTY(double failedWriteCount READ failedWriteCount NOTIFY statisticsChanged FINAL)
+    Q_PROPERTY(double failedMappingCount READ failedMappingCount NOTIFY statisticsChanged FINAL)
+
+public:
+#ifdef Q_ATOMIC_INT64_IS_SUPPORTED
+    using Counter = QAtomicInteger<quint64>;
+#else
+    using Counter = QAtomicInteger<quint32>;
+#endif
+
+public:
+    explicit StyleStatistics(QObject *parent = nullptr);
+    ~StyleStatistics() override = default;
+
+    static QObject *qmlSingleton(QQmlEngine *engine, QJSEngine *scriptEngine);
+
+    static bool isEnabled() noexcept;
+
+    int updateInterval() const noexcept;
+    void setUpdateInterval(int msecs);
+
+    int dispatcherCount() const noexcept;
+    QVariantMap mappedControls() const;
+    QVariantMap statesPerStyle() const;
+    int expressionCount() const noexcept;
+
+    double dispatchCount() const noexcept;
+    double writeCount() const noexcept;
+    double dispatchesPerSecond() const noexcept;
+    double writesPerSecond() const noexcept;
+    double failedWriteCount() const noexcept;
+    double failedMappingCount() const noexcept;
+
+    Q_INVOKABLE void update();
+    Q_INVOKABLE void reset();
+
+    Q_INVOKABLE QVariantMap memoryUsage() const;
+    Q_INVOKABLE double controlMemoryUsage(QQuickItem *item) const;
+
+    static void recordDispatch() noexcept;
+    static void recordWrites(int writes) noexcept;
+    static void recordFailedWrite() noexcept;
+    static void recordFailedMapping() noexcept;
+
+signals:
+    void updateIntervalChanged();
+    void statisticsChanged();
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    Q_DISABLE_COPY(StyleStatistics)
+
+    void updateCounters();
+
+    static Counter m_dispatches;
+    static Counter m_writes;
+    static Counter m_failedWrites;
+    static Counter m_failedMappings;
+
+    const QQmlEngine *m_engine{nullptr};
+    QBasicTimer m_timer{};
+    QElapsedTimer m_elapsedTimer{};
+    int m_updateInterval{1000};
+    int m_dispatcherCount{};
+    int m_expressionCount{};
+    QVariantMap m_mappedControls{};
+    QVariantMap m_statesPerStyle{};
+    quint64 m_lastDispatches{};
+    quint64 m_lastWrites{};
+    double m_dispatchesPerSecond{};
+    double m_writesPerSecond{};
+};
+
+//--------------------------------------------------------------------------------------------------
+
+inline bool StyleStatistics::isEnabled() noexcept
+{
+#ifdef SCT_NO_STYLE_STATISTICS
+    return false;
+#else
+    return true;
+#endif
+}
+
+inline void StyleStatistics::recordDispatch() noexcept
+{
+#ifndef SCT_NO_STYLE_STATISTICS
+    m_dispatches.fetchAndAddRelaxed(1);
+#endif
+}
+
+inline void StyleStatistics::recordWrites(int writes) noexcept
+{
+#ifndef SCT_NO_STYLE_STATISTICS
+    m_writes.fetchAndAddRelaxed(static_cast<Counter::Type>(writes));
+#else
+    Q_UNUSED(writes);
+#endif
+}
+
+inline void StyleStatistics::recordFailedWrite() noexcept
+{
+#ifndef SCT_NO_STYLE_STATISTICS
+    m_failedWrites.fetchAndAddRelaxed(1);
+#endif
+}
+
+inline void StyleStatistics::recordFailedMapping() noexcept
+{
+#ifndef SCT_NO_STYLE_STATISTICS
+    m_failedMappings.fetchAndAddRelaxed(1);
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
+
+#endif // STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLESTATISTICS_HPP
@@ -0,0 +1,473 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "styletracerecorder.hpp"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThread>
+#include <QtCore/QtDebug>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+namespace {
+
+#ifdef Q_ATOMIC_INT64_IS_SUPPORTED
+using Index = quint64;
+#else
+using Index = quint32;
+#endif
+
+using Head = QAtomicInteger<Index>;
+
+struct Buffer
+{
+    Buffer(int capacity, int threadId, const QString &threadName)
+        : events{new StyleTraceRecorder::Event[capacity]}
+        , capacity{static_cast<quint32>(capacity)}
+        , threadId{threadId}
+        , threadName{threadName}
+    {
+    }
+
+    std::unique_ptr<StyleTraceRecorder::Event[]> events;
+    const quint32 capacity;
+    Head head{0};
+    Head writing{0};
+    Index start{0};
+    const int threadId;
+    const QString threadName;
+};
+
+struct Registry
+{
+    QMutex mutex{};
+    std::vector<std::unique_ptr<Buffer>> buffers{};
+    int capacity{16384};
+    QElapsedTimer clock{};
+};
+
+Q_GLOBAL_STATIC(Registry, s_registry)
+
+// each thread owns its ring buffer and is its only writer, so an event is recorded without any
+// lock. The readers hold the lock of the registry, which keeps the buffers alive after the end of
+// their thread in order to dump them.
+thread_local Buffer *t_buffer{nullptr};
+
+int nextPowerOfTwo(int value)
+{
+    int result{1};
+
+    while (result < value)
+        result <<= 1;
+
+    return result;
+}
+
+Buffer *registerThread()
+{
+    auto *const registry = s_registry();
+
+    if (!registry)
+        return nullptr;
+
+    QMutexLocker locker{&registry->mutex};
+
+    const int threadId = static_cast<int>(registry->buffers.size()) + 1;
+    auto *const thread = QThread::currentThread();
+    auto *const application = QCoreApplication::instance();
+
+    QString threadName = thread ? thread->objectName() : QString{};
+
+    if (application && application->thread() == thread)
+        threadName = QStringLiteral("Main thread");
+    else if (threadName.isEmpty())
+        threadName = QStringLiteral("Thread %1").arg(threadId);
+
+    registry->buffers.emplace_back(new Buffer{registry->capacity, threadId, threadName});
+
+    return registry->buffers.back().get();
+}
+
+QString categoryName(StyleTraceRecorder::Category category)
+{
+    switch (category)
+    {
+    case StyleTraceRecorder::Category::Dispatch:
+        return QStringLiteral("dispatch");
+    case StyleTraceRecorder::Category::State:
+        return QStringLiteral("state");
+    case StyleTraceRecorder::Category::Geometry:
+        return QStringLiteral("geometry");
+    case StyleTraceRecorder::Category::Factory:
+        return QStringLiteral("factory");
+    case StyleTraceRecorder::Category::Control:
+        return QStringLiteral("control");
+    case StyleTraceRecorder::Category::Parser:
+        return QStringLiteral("parser");
+    }
+
+    return QString{};
+}
+
+void dumpAtExit()
+{
+    const auto filePath = QString::fromLocal8Bit(qgetenv("SCT_TRACE_FILE"));
+
+    if (!filePath.isEmpty())
+        StyleTraceRecorder::dump(filePath);
+}
+
+void initialiseFromEnvironment()
+{
+    StyleTraceRecorder::initialise();
+}
+
+} // namespace
+
+Q_COREAPP_STARTUP_FUNCTION(initialiseFromEnvironment)
+
+QBasicAtomicInt StyleTraceRecorder::m_enabled = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+
+/*! \class StyleTraceRecorder
+    \since StoiridhControlsTemplates 1.0
+    \ingroup diagnostics
+
+    \brief The StyleTraceRecorder class records the style and layout activity in the Chrome
+           trace-event format.
+
+    The recorder is opt-in and is enabled by setting the \c SCT_TRACE_FILE environment variable to
+    the path of the trace file, which is written when the application exits:
+
+    \code
+    SCT_TRACE_FILE=/tmp/style.json ./application
+    \endcode
+
+    The resulting file can be opened with \c chrome://tracing or the Perfetto UI in order to
+    correlate the style bursts with the frames of the application. The trace can also be written
+    on demand with dump().
+
+    The following activities are recorded:
+
+    \list
+        \li \c dispatch: the dispatch of a style to a control.
+        \li \c state: the transitions of the style's state of a control.
+        \li \c geometry: the computation of the background and content geometries of a control.
+        \li \c factory: the creation and mapping of the styles by the StyleFactory.
+        \li \c control: the completion of the controls.
+        \li \c parser: the verification and decoding of the StylePropertyChanges bindings.
+    \endlist
+
+    Each thread records its events into its own ring buffer without any lock, so the recording
+    threads are never blocked, even while the trace is generated. When a ring buffer is full, the
+    oldest events are overwritten; the capacity can be changed with the \c SCT_TRACE_CAPACITY
+    environment variable. When the recorder is disabled, recording an event costs a single relaxed
+    atomic load.
+
+    \note The name of an event must be a string literal since only its address is recorded.
+
+    \sa StyleTraceScope
+*/
+
+
+/*!
+    Enables the recorder if \a enabled is true, otherwise, disables it.
+*/
+void StyleTraceRecorder::setEnabled(bool enabled)
+{
+    if (enabled)
+    {
+        auto *const registry = s_registry();
+        QMutexLocker locker{&registry->mutex};
+
+        if (!registry->clock.isValid())
+            registry->clock.start();
+    }
+
+    m_enabled.store(enabled ? 1 : 0);
+}
+
+/*!
+    Returns the number of events held by the ring buffer of a thread.
+
+    The default capacity is 16384 events.
+*/
+int StyleTraceRecorder::capacity() noexcept
+{
+    auto *const registry = s_registry();
+    return registry ? registry->capacity : 0;
+}
+
+/*!
+    Sets the \a capacity of the ring buffers, rounded up to the next power of two.
+
+    \note The capacity only applies to the threads that have not recorded any event yet.
+*/
+void StyleTraceRecorder::setCapacity(int capacity)
+{
+    auto *const registry = s_registry();
+    QMutexLocker locker{&registry->mutex};
+
+    registry->capacity = nextPowerOfTwo(qMax(1, capacity));
+}
+
+/*!
+    Returns the number of nanoseconds elapsed since the recorder has been enabled for the first
+    time.
+*/
+qint64 StyleTraceRecorder::now() noexcept
+{
+    auto *const registry = s_registry();
+    return (registry && registry->clock.isValid()) ? registry->clock.nsecsElapsed() : 0;
+}
+
+/*!
+    Records a complete event named \a name of the \a category for the \a object, which started at
+    \a timestamp and lasted \a duration nanoseconds.
+
+    \sa StyleTraceScope
+*/
+void StyleTraceRecorder::complete(const char *name, Category category, const void *object,
+                                  qint64 timestamp, qint64 duration) noexcept
+{
+    record(Event{name, object, timestamp, duration, category, 'X'});
+}
+
+/*! \internal */
+void StyleTraceRecorder::record(const Event &event) noexcept
+{
+    if (Q_UNLIKELY(!t_buffer))
+    {
+        t_buffer = registerThread();
+
+        if (!t_buffer)
+            return;
+    }
+
+    // the slot being written is announced before it is overwritten, so that a reader copying the
+    // ring buffer at the same time can discard it, as the reader of a sequence lock does.
+    const auto head = t_buffer->head.load();
+    t_buffer->writing.store(head + 1);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    t_buffer->events[head & (t_buffer->capacity - 1)] = event;
+    t_buffer->head.storeRelease(head + 1);
+}
+
+/*!
+    Returns the recorded events in the Chrome trace-event JSON format.
+
+    The ring buffer of each thread is copied while the thread may still record events, then the
+    events that may have been overwritten during the copy are discarded.
+*/
+QByteArray StyleTraceRecorder::toJson()
+{
+    auto *const registry = s_registry();
+
+    if (!registry)
+        return QByteArray{};
+
+    QMutexLocker locker{&registry->mutex};
+
+    const auto pid = static_cast<double>(QCoreApplication::applicationPid());
+    QJsonArray traceEvents{};
+
+    for (const auto &buffer : registry->buffers)
+    {
+        traceEvents.append(QJsonObject{
+            {QStringLiteral("name"), QStringLiteral("thread_name")},
+            {QStringLiteral("ph"), QStringLiteral("M")},
+            {QStringLiteral("pid"), pid},
+            {QStringLiteral("tid"), buffer->threadId},
+            {QStringLiteral("args"), QJsonObject{{QStringLiteral("name"), buffer->threadName}}}
+        });
+
+        const Index head = buffer->head.loadAcquire();
+        const Index count = qMin<Index>(head - buffer->start, buffer->capacity);
+
+        std::vector<Event> events{};
+        events.reserve(count);
+
+        for (auto index = head - count; index != head; ++index)
+            events.push_back(buffer->events[index & (buffer->capacity - 1)]);
+
+        // the events whose slot has been overwritten since the head was read are discarded.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const Index writing = buffer->writing.load();
+        const Index overwritten = writing - head;
+        const Index valid = overwritten < buffer->capacity
+                ? qMin<Index>(count, buffer->capacity - overwritten) : 0;
+        const auto first = events.cend() - static_cast<std::ptrdiff_t>(valid);
+
+        for (auto it = first; it != events.cend(); ++it)
+        {
+            const auto &event = *it;
+
+            QJsonObject traceEvent{
+                {QStringLiteral("name"), QString::fromLatin1(event.name)},
+                {QStringLiteral("cat"), categoryName(event.category)},
+                {QStringLiteral("ph"), QString{QLatin1Char(event.phase)}},
+                {QStringLiteral("ts"), event.timestamp / 1000.0},
+                {QStringLiteral("pid"), pid},
+                {QStringLiteral("tid"), buffer->threadId},
+                {QStringLiteral("args"), QJsonObject{
+                     {QStringLiteral("object"),
+                      QStringLiteral("0x%1").arg(reinterpret_cast<quintptr>(event.object), 0, 16)}
+                 }}
+            };
+
+            if (event.phase == 'X')
+                traceEvent.insert(QStringLiteral("dur"), event.duration / 1000.0);
+            else
+                traceEvent.insert(QStringLiteral("s"), QStringLiteral("t"));
+
+            traceEvents.append(traceEvent);
+        }
+    }
+
+    const QJsonObject trace{
+        {QStringLiteral("traceEvents"), traceEvents},
+        {QStringLiteral("displayTimeUnit"), QStringLiteral("ms")}
+    };
+
+    return QJsonDocument{trace}.toJson(QJsonDocument::Compact);
+}
+
+/*!
+    Writes the recorded events to \a filePath in the Chrome trace-event JSON format.
+
+    \return true if the trace has been written, otherwise, false.
+*/
+bool StyleTraceRecorder::dump(const QString &filePath)
+{
+    QSaveFile file{filePath};
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qWarning("StyleTraceRecorder: unable to open %s: %s", qPrintable(filePath),
+                 qPrintable(file.errorString()));
+        return false;
+    }
+
+    file.write(toJson());
+
+    return file.commit();
+}
+
+/*!
+    Discards the recorded events.
+*/
+void StyleTraceRecorder::clear()
+{
+    auto *const registry = s_registry();
+    QMutexLocker locker{&registry->mutex};
+
+    // the events are discarded from the reader side, the recording threads are not blocked.
+    for (const auto &buffer : registry->buffers)
+    {
+        buffer->start = buffer->head.loadAcquire();
+    }
+}
+
+/*!
+    Initialises the recorder from the \c SCT_TRACE_FILE and \c SCT_TRACE_CAPACITY environment
+    variables.
+
+    The function is called automatically when the QCoreApplication is constructed.
+*/
+void StyleTraceRecorder::initialise()
+{
+    if (!qEnvironmentVariableIsEmpty("SCT_TRACE_CAPACITY"))
+        setCapacity(qEnvironmentVariableIntValue("SCT_TRACE_CAPACITY"));
+
+    if (qEnvironmentVariableIsEmpty("SCT_TRACE_FILE") || isEnabled())
+        return;
+
+    setEnabled(true);
+    qAddPostRoutine(dumpAtExit);
+}
+
+/*! \class StyleTraceScope
+    \since StoiridhControlsTemplates 1.0
+    \ingroup diagnostics
+
+    \brief The StyleTraceScope class records a complete event for the duration of a scope.
+
+    \code
+    void ControlPrivate::calculateContentGeometry()
+    {
+        StyleTraceScope scope{"calculateContentGeometry", StyleTraceRecorder::Category::Geometry,
+                              q_func()};
+        // ...
+    }
+    \endcode
+
+    \sa StyleTraceRecorder
+*/
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////   DOCUMENTATION    ////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \enum StyleTraceRecorder::Category
+
+    This enum type specifies the category of an event:
+
+    \value Dispatch The dispatch of a style to a control.
+    \value State    The transition of the style's state of a control.
+    \value Geometry The computation of the geometry of a control.
+    \value Factory  The creation and mapping of a style.
+    \value Control  The completion of a control.
+    \value Parser   The verification or decoding of the bindings of a StylePropertyChanges.
+*/
+
+/*! \fn bool StyleTraceRecorder::isEnabled() noexcept
+
+    Returns true if the recorder records the events, otherwise, false.
+*/
+
+/*! \fn void StyleTraceRecorder::instant(const char *name, Category category,
+                                         const void *object) noexcept
+
+    Records an instant event named \a name of the \a category for the \a object.
+*/
+
+/*! \fn StyleTraceScope::StyleTraceScope(const char *name, StyleTraceRecorder::Category category,
+                                         const void *object) noexcept
+
+    Constructs a style trace scope that records, on destruction, a complete event named \a name of
+    the \a category for the \a object, provided that the recorder is enabled.
+*/
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
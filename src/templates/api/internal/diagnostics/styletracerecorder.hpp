@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLETRACERECORDER_HPP
+#define STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLETRACERECORDER_HPP
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  --------------------------------------------------------------------------------------------  //
+//  /!\                                     W A R N I N G                                    /!\  //
+//  --------------------------------------------------------------------------------------------  //
+//                                                                                                //
+//  This internal header file is not part of StoiridhControlsTemplates API. It exists purely as   //
+//  an internal use and must not be used in external project(s).                                  //
+//                                                                                                //
+//  The content of this file may change from version to version without notice, or even be        //
+//  removed.                                                                                      //
+//                                                                                                //
+//  You are forewarned!                                                                           //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "api/internal/global.hpp"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+class SCT_INTERNAL_API StyleTraceRecorder final
+{
+public:
+    enum class Category : quint8
+    {
+        Dispatch,
+        State,
+        Geometry,
+        Factory,
+        Control,
+        Parser
+    };
+
+    struct Event
+    {
+        const char *name;
+        const void *object;
+        qint64 timestamp;
+        qint64 duration;
+        Category category;
+        char phase;
+    };
+
+public:
+    StyleTraceRecorder() = delete;
+
+    static bool isEnabled() noexcept;
+    static void setEnabled(bool enabled);
+
+    static int capacity() noexcept;
+    static void setCapacity(int capacity);
+
+    static qint64 now() noexcept;
+
+    static void complete(const char *name, Category category, const void *object,
+                         qint64 timestamp, qint64 duration) noexcept;
+    static void instant(const char *name, Category category, const void *object) noexcept;
+
+    static QByteArray toJson();
+    static bool dump(const QString &filePath);
+    static void clear();
+
+    static void initialise();
+
+private:
+    static void record(const Event &event) noexcept;
+
+private:
+    static QBasicAtomicInt m_enabled;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+class StyleTraceScope final
+{
+public:
+    StyleTraceScope(const char *name, StyleTraceRecorder::Category category,
+                    const void *object) noexcept;
+    StyleTraceScope(const StyleTraceScope &rhs) = delete;
+    StyleTraceScope(StyleTraceScope &&rhs) = delete;
+    ~StyleTraceScope();
+
+    StyleTraceScope &operator=(const StyleTraceScope &rhs) = delete;
+    StyleTraceScope &operator=(StyleTraceScope &&rhs) = delete;
+
+private:
+    const char *m_name;
+    const void *m_object;
+    qint64 m_timestamp;
+    StyleTraceRecorder::Category m_category;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+inline bool StyleTraceRecorder::isEnabled() noexcept
+{
+    return m_enabled.load() != 0;
+}
+
+inline void StyleTraceRecorder::instant(const char *name, Category category,
+                                        const void *object) noexcept
+{
+    if (Q_UNLIKELY(isEnabled()))
+        record(Event{name, object, now(), 0, category, 'i'});
+}
+
+inline StyleTraceScope::StyleTraceScope(const char *name, StyleTraceRecorder::Category category,
+                                        const void *object) noexcept
+    : m_name{name}
+    , m_object{object}
+    , m_timestamp{StyleTraceRecorder::isEnabled() ? StyleTraceRecorder::now() : -1}
+    , m_category{category}
+{
+}
+
+inline StyleTraceScope::~StyleTraceScope()
+{
+    if (Q_UNLIKELY(m_timestamp >= 0))
+    {
+        StyleTraceRecorder::complete(m_name, m_category, m_object, m_timestamp,
+                                     StyleTraceRecorder::now() - m_timestamp);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
+
+#endif // STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLETRACERECORDER_HPP
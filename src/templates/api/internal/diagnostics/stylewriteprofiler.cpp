@@ -0,0 +1,388 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "stylewriteprofiler.hpp"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QtDebug>
+#include <QtQml/QQmlProperty>
+#include <QtQml/qqml.h>
+
+#include <QtCore/private/qmetaobject_p.h>
+#include <QtQml/private/qqmlmetatype_p.h>
+
+#include <algorithm>
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+namespace {
+
+// the writes are aggregated by meta-object and property index since the type names of distinct
+// types may collide, e.g., two QML components with the same name from different modules. The name
+// of a property only identifies the properties that could not be resolved or that are declared in
+// QML.
+struct Key
+{
+    const QMetaObject *control;
+    const QMetaObject *target;
+    const QMetaObject *owner;
+    int propertyIndex;
+    QString property;
+};
+
+bool operator==(const Key &lhs, const Key &rhs)
+{
+    return lhs.control == rhs.control && lhs.target == rhs.target && lhs.owner == rhs.owner
+            && lhs.propertyIndex == rhs.propertyIndex && lhs.property == rhs.property;
+}
+
+uint qHash(const Key &key, uint seed = 0)
+{
+    return ::qHash(key.control, seed) ^ ::qHash(key.target, seed) ^ ::qHash(key.owner, seed)
+            ^ ::qHash(key.propertyIndex, seed) ^ ::qHash(key.property, seed);
+}
+
+// returns the first meta-object of the object that is not dynamic. A dynamic meta-object, e.g., of
+// a QML component declaring properties, belongs to a single object and may be freed with it, so
+// that its address could be reused by an object of another type.
+const QMetaObject *metaObjectOf(const QObject *object)
+{
+    auto *metaObject = object ? object->metaObject() : nullptr;
+
+    while (metaObject && (QMetaObjectPrivate::get(metaObject)->flags & DynamicMetaObject))
+        metaObject = metaObject->superClass();
+
+    return metaObject;
+}
+
+QString typeNameOf(const QMetaObject *metaObject)
+{
+    if (!metaObject)
+        return {};
+
+    if (auto *const qmlType = QQmlMetaType::qmlType(metaObject))
+        return qmlType->qmlTypeName();
+
+    return QString::fromUtf8(metaObject->className());
+}
+
+struct Registry
+{
+    QMutex mutex{};
+    QHash<Key, StyleWriteProfiler::Entry> entries{};
+};
+
+Q_GLOBAL_STATIC(Registry, s_registry)
+
+void dumpAtExit()
+{
+    const auto output = QString::fromLocal8Bit(qgetenv("SCT_WRITE_PROFILE"));
+
+    if (output == QLatin1String("1"))
+        qDebug().noquote() << StyleWriteProfiler::table();
+    else
+        StyleWriteProfiler::dump(output);
+}
+
+void initialiseFromEnvironment()
+{
+    StyleWriteProfiler::initialise();
+}
+
+} // namespace
+
+Q_COREAPP_STARTUP_FUNCTION(initialiseFromEnvironment)
+
+QBasicAtomicInt StyleWriteProfiler::m_enabled = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+
+/*! \class StyleWriteProfiler
+    \since StoiridhControlsTemplates 1.0
+    \ingroup diagnostics
+
+    \brief The StyleWriteProfiler class aggregates the property writes of the style property
+           expressions.
+
+    When enabled, each property write of a StylePropertyExpression is aggregated by control type,
+    target type and property in order to find out:
+
+    \list
+        \li the properties that are written the most often and their total write time,
+        \li the writes that failed because the property was either invalid or read-only,
+        \li the writes that were no-ops because the property already held the value.
+    \endlist
+
+    The profiler is opt-in and is enabled by the \c SCT_WRITE_PROFILE environment variable. When
+    the application exits, the table of the writes is printed on the standard error output if the
+    variable is \c 1, otherwise, it is written to the file at the path held by the variable:
+
+    \code
+    SCT_WRITE_PROFILE=/tmp/writes.txt ./application
+    \endcode
+
+    \note Detecting the no-op writes requires to read the property before writing it, so the
+          profiler must not be enabled in order to measure the performance of the application.
+*/
+
+
+/*!
+    Enables the profiler if \a enabled is true, otherwise, disables it.
+*/
+void StyleWriteProfiler::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled ? 1 : 0);
+}
+
+/*!
+    Returns the aggregated property writes, sorted by descending number of writes.
+*/
+QVector<StyleWriteProfiler::Entry> StyleWriteProfiler::entries()
+{
+    QVector<Entry> result{};
+
+    if (auto *const registry = s_registry())
+    {
+        QMutexLocker locker{&registry->mutex};
+        result.reserve(registry->entries.count());
+
+        for (const auto &entry : registry->entries)
+        {
+            result.append(entry);
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const Entry &lhs, const Entry &rhs) {
+        return lhs.writes > rhs.writes;
+    });
+
+    return result;
+}
+
+/*!
+    Returns the aggregated property writes as a plain-text table.
+*/
+QString StyleWriteProfiler::table()
+{
+    const auto rows = entries();
+
+    QString result{};
+    QTextStream stream{&result};
+
+    stream << qSetFieldWidth(24) << left
+           << QStringLiteral("Control") << QStringLiteral("Target") << QStringLiteral("Property")
+           << qSetFieldWidth(12) << right
+           << QStringLiteral("Writes") << QStringLiteral("Total (ms)") << QStringLiteral("Mean (us)")
+           << QStringLiteral("Failures") << QStringLiteral("No-ops")
+           << qSetFieldWidth(0) << endl;
+
+    for (const auto &row : rows)
+    {
+        const auto mean = row.writes > 0 ? row.totalTime / 1000.0 / row.writes : 0.0;
+
+        stream << qSetFieldWidth(24) << left
+               << row.controlType << row.target << row.property
+               << qSetFieldWidth(12) << right << fixed << qSetRealNumberPrecision(3)
+               << row.writes << row.totalTime / 1000000.0 << mean << row.failures << row.noOps
+               << qSetFieldWidth(0) << endl;
+    }
+
+    return result;
+}
+
+/*!
+    Writes the table of the property writes to \a filePath.
+
+    \return true if the table has been written, otherwise, false.
+
+    \sa table()
+*/
+bool StyleWriteProfiler::dump(const QString &filePath)
+{
+    QSaveFile file{filePath};
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        qWarning("StyleWriteProfiler: unable to open %s: %s", qPrintable(filePath),
+                 qPrintable(file.errorString()));
+        return false;
+    }
+
+    file.write(table().toUtf8());
+
+    return file.commit();
+}
+
+/*!
+    Discards the aggregated property writes.
+*/
+void StyleWriteProfiler::clear()
+{
+    auto *const registry = s_registry();
+    QMutexLocker locker{&registry->mutex};
+
+    registry->entries.clear();
+}
+
+/*!
+    Initialises the profiler from the \c SCT_WRITE_PROFILE environment variable.
+
+    The function is called automatically when the QCoreApplication is constructed.
+*/
+void StyleWriteProfiler::initialise()
+{
+    if (qEnvironmentVariableIsEmpty("SCT_WRITE_PROFILE") || isEnabled())
+        return;
+
+    setEnabled(true);
+    qAddPostRoutine(dumpAtExit);
+}
+
+/*!
+    \internal
+
+    Aggregates the \a entry of the write to the property at \a propertyIndex of the \a owner
+    meta-object, on the \a target of the \a control.
+
+    The writes are aggregated by type: the \a control and the \a target are identified by their
+    first meta-object that is not dynamic, and the \a owner must not be dynamic either.
+
+    The type names are only resolved the first time the property is written.
+*/
+void StyleWriteProfiler::record(const QObject *control, const QObject *target,
+                                const QMetaObject *owner, int propertyIndex, const Entry &entry)
+{
+    auto *const registry = s_registry();
+
+    if (!registry)
+        return;
+
+    // a property declared in QML is only known by its name once its owner is not dynamic.
+    if (owner && propertyIndex >= owner->propertyCount())
+        propertyIndex = -1;
+
+    const Key key{metaObjectOf(control), metaObjectOf(target), owner, propertyIndex,
+                  propertyIndex < 0 ? entry.property : QString{}};
+
+    QMutexLocker locker{&registry->mutex};
+
+    auto &aggregate = registry->entries[key];
+
+    if (aggregate.writes == 0 && aggregate.failures == 0)
+    {
+        aggregate.controlType = typeNameOf(key.control);
+        aggregate.target = typeNameOf(key.target);
+        aggregate.property = entry.property;
+    }
+
+    aggregate.writes += entry.writes;
+    aggregate.totalTime += entry.totalTime;
+    aggregate.failures += entry.failures;
+    aggregate.noOps += entry.noOps;
+}
+
+/*! \class StyleWriteProfiler::Scope
+    \since StoiridhControlsTemplates 1.0
+    \ingroup diagnostics
+
+    \brief The StyleWriteProfiler::Scope class profiles a property write for the duration of a
+           scope.
+
+    \code
+    StyleWriteProfiler::Scope scope{control, target, name, value};
+
+    QQmlProperty property{target, name, QtQml::qmlContext(control)};
+
+    if (property.isValid() && property.isWritable())
+        property.write(value);
+    \endcode
+
+    The property is only resolved when the profiler is enabled, so that a disabled scope costs a
+    single atomic load.
+*/
+
+/*! \internal */
+void StyleWriteProfiler::Scope::start(const QObject *control, QObject *target,
+                                      const QString &name, const QVariant &value)
+{
+    const QQmlProperty property{target, name, QtQml::qmlContext(control)};
+
+    m_isActive = true;
+    m_control = control;
+    m_target = target;
+    m_owner = metaObjectOf(property.object());
+    m_propertyIndex = property.index();
+    m_entry.property = name;
+
+    m_isFailure = !property.isValid() || !property.isWritable();
+
+    if (!m_isFailure)
+    {
+        // compare the values once converted to the type of the property, as the write would do.
+        auto converted = value;
+
+        if (converted.convert(property.propertyType()))
+            m_isNoOp = (property.read() == converted);
+    }
+
+    m_timer.start();
+}
+
+/*! \internal */
+void StyleWriteProfiler::Scope::finish()
+{
+    m_entry.totalTime = m_timer.nsecsElapsed();
+
+    if (m_isFailure)
+    {
+        m_entry.failures = 1;
+    }
+    else
+    {
+        m_entry.writes = 1;
+        m_entry.noOps = m_isNoOp ? 1 : 0;
+    }
+
+    StyleWriteProfiler::record(m_control, m_target, m_owner, m_propertyIndex, m_entry);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////   DOCUMENTATION    ////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \fn bool StyleWriteProfiler::isEnabled() noexcept
+
+    Returns true if the profiler aggregates the property writes, otherwise, false.
+*/
+
+/*! \fn StyleWriteProfiler::Scope::Scope(const QObject *control, QObject *target,
+                                         const QString &name, const QVariant &value)
+
+    Constructs a scope that profiles the write of the \a value to the property named \a name of
+    the \a target of the \a control, provided that the profiler is enabled.
+*/
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
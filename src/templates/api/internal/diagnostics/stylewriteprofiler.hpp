@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLEWRITEPROFILER_HPP
+#define STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLEWRITEPROFILER_HPP
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  --------------------------------------------------------------------------------------------  //
+//  /!\                                     W A R N I N G                                    /!\  //
+//  --------------------------------------------------------------------------------------------  //
+//                                                                                                //
+//  This internal header file is not part of StoiridhControlsTemplates API. It exists purely as   //
+//  an internal use and must not be used in external project(s).                                  //
+//                                                                                                //
+//  The content of this file may change from version to version without notice, or even be        //
+//  removed.                                                                                      //
+//                                                                                                //
+//  You are forewarned!                                                                           //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "api/internal/global.hpp"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+struct QMetaObject;
+class QObject;
+class QVariant;
+QT_END_NAMESPACE
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+class SCT_INTERNAL_API StyleWriteProfiler final
+{
+public:
+    struct Entry
+    {
+        QString controlType{};
+        QString target{};
+        QString property{};
+        qint64 writes{};
+        qint64 totalTime{};
+        qint64 failures{};
+        qint64 noOps{};
+    };
+
+    class Scope final
+    {
+    public:
+        Scope(const QObject *control, QObject *target, const QString &name,
+              const QVariant &value);
+        Scope(const Scope &rhs) = delete;
+        Scope(Scope &&rhs) = delete;
+        ~Scope();
+
+        Scope &operator=(const Scope &rhs) = delete;
+        Scope &operator=(Scope &&rhs) = delete;
+
+    private:
+        void start(const QObject *control, QObject *target, const QString &name,
+                   const QVariant &value);
+        void finish();
+
+    private:
+        bool m_isActive{false};
+        bool m_isFailure{false};
+        bool m_isNoOp{false};
+        QElapsedTimer m_timer{};
+        const QObject *m_control{nullptr};
+        const QObject *m_target{nullptr};
+        const QMetaObject *m_owner{nullptr};
+        int m_propertyIndex{-1};
+        Entry m_entry{};
+    };
+
+public:
+    StyleWriteProfiler() = delete;
+
+    static bool isEnabled() noexcept;
+    static void setEnabled(bool enabled);
+
+    static QVector<Entry> entries();
+    static QString table();
+    static bool dump(const QString &filePath);
+    static void clear();
+
+    static void initialise();
+
+private:
+    static void record(const QObject *control, const QObject *target, const QMetaObject *owner,
+                       int propertyIndex, const Entry &entry);
+
+private:
+    static QBasicAtomicInt m_enabled;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+inline bool StyleWriteProfiler::isEnabled() noexcept
+{
+    return m_enabled.load() != 0;
+}
+
+inline StyleWriteProfiler::Scope::Scope(const QObject *control, QObject *target,
+                                        const QString &name, const QVariant &value)
+{
+    if (Q_UNLIKELY(isEnabled()))
+        start(control, target, name, value);
+}
+
+inline StyleWriteProfiler::Scope::~Scope()
+{
+    if (Q_UNLIKELY(m_isActive))
+        finish();
+}
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
+
+#endif // STOIRIDHCONTROLSTEMPLATES_INTERNAL_DIAGNOSTICS_STYLEWRITEPROFILER_HPP
@@ -58,7 +58,9 @@ AbstractStyleDispatcher::AbstractStyleDispatcher(Style *style, QObject *parent)
     : QObject{parent}
     , m_style{style}
 {
-    ExceptionHandler::checkNullPointer(style, QStringLiteral("style"), QStringLiteral("Style *"));
+    if (!ExceptionHandler::checkNullPointer(style, QStringLiteral("style"),
+                                            QStringLiteral("Style *")))
+        return;
 
     m_style->setParent(this);
 
@@ -157,7 +157,7 @@ void Style::setName(const QString &name)
 void StylePrivate::init()
 {
     Q_Q(Style);
-    m_stateController = QSharedPointer<StyleStateController>::create(q);
+    m_stateController.reset(new StyleStateController{q});
 }
 
 /*!
@@ -187,12 +187,15 @@ void StylePrivate::setStyleDispatcher(AbstractStyleDispatcher *dispatcher)
 /*!
     Returns the style state controller.
 
+    The style state controller is owned by the style, the returned pointer is borrowed and must not
+    be kept beyond the lifetime of the style.
+
     \note This method will always return a valid StyleStateController object.
     \sa StyleStateController
 */
-QWeakPointer<StyleStateController> StylePrivate::stateController() const
+StyleStateController *StylePrivate::stateController() const
 {
-    return m_stateController.toWeakRef();
+    return m_stateController.data();
 }
 
 void StylePrivate::style_state_append(StyleStateListProperty *property, StyleState *value)
@@ -21,8 +21,12 @@
 #include "control.hpp"
 #include "core/exception/exceptionhandler.hpp"
 
+#include "api/internal/diagnostics/styleprofilerrange.hpp"
+#include "api/internal/diagnostics/stylestatistics.hpp"
+#include "api/internal/diagnostics/styletracerecorder.hpp"
 #include "api/internal/style/stylestatecontroller.hpp"
 
+#include "api/private/control_p.hpp"
 #include "api/private/style/style_p.hpp"
 
 //--------------------------------------------------------------------------------------------------
@@ -49,15 +53,35 @@ namespace StoiridhControlsTemplates {
 */
 void StyleDispatcher::dispatch(const Control *control)
 {
-    ExceptionHandler::checkNullPointer(control,
-                                       QStringLiteral("control"),
-                                       QStringLiteral("const Control *"));
+    if (!ExceptionHandler::checkNullPointer(control,
+                                            QStringLiteral("control"),
+                                            QStringLiteral("const Control *")))
+        return;
+
+    StyleProfilerRange range{control, [control]() {
+        return QStringLiteral("StyleDispatcher::dispatch %1 [%2]")
+                .arg(StyleProfilerRange::typeName(control))
+                .arg(ControlPrivate::get(control)->styleState());
+    }};
+    StyleTraceScope scope{"StyleDispatcher::dispatch", StyleTraceRecorder::Category::Dispatch,
+                          control};
 
     auto *const d_style = StylePrivate::get(style());
 
-    if (auto controller = d_style->stateController().lock())
+    if (auto *const controller = d_style->stateController())
     {
-        controller->apply(control);
+        // the control is validated once, the dispatch path below doesn't check it again.
+        const auto writes = controller->applyUnchecked(control);
+
+        StyleStatistics::recordDispatch();
+        StyleStatistics::recordWrites(writes);
+
+        range.update([control, writes]() {
+            return QStringLiteral("StyleDispatcher::dispatch %1 [%2] %3 writes")
+                    .arg(StyleProfilerRange::typeName(control))
+                    .arg(ControlPrivate::get(control)->styleState())
+                    .arg(writes);
+        });
     }
 }
 
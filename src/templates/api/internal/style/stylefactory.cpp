@@ -18,11 +18,37 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #include "stylefactory.hpp"
 
+#include "api/internal/diagnostics/stylestatistics.hpp"
+#include "api/internal/style/style.hpp"
+#include "api/internal/style/stylescheduler.hpp"
+#include "api/internal/style/stylewarmup.hpp"
+
+#include <QtCore/QThread>
+
+#include <QtCore/private/qmetaobject_p.h>
+#include <QtQml/private/qqmldata_p.h>
+#include <QtQml/private/qqmlpropertycache_p.h>
+
 //--------------------------------------------------------------------------------------------------
 namespace StoiridhControlsTemplates {
 //--------------------------------------------------------------------------------------------------
 
-QHash<QString, AbstractStyleDispatcher *> StyleFactory::m_dispatchers{};
+QHash<StyleFactory::RegistryKey, StyleFactory::Registry *> StyleFactory::m_registries{};
+quint64 StyleFactory::m_generation{0};
+QMutex StyleFactory::m_mutex{};
+
+// returns the identity of the type of control: its meta-object, or, if the control has declared
+// properties in QML, the property cache shared by the instances of its QML declaration.
+static const void *typeOf(const Control *control)
+{
+    const auto *const metaObject = control->metaObject();
+
+    if (!(QMetaObjectPrivate::get(metaObject)->flags & DynamicMetaObject))
+        return metaObject;
+
+    const auto *const data = QQmlData::get(control);
+    return data ? data->propertyCache : nullptr;
+}
 
 
 /*! \class StyleFactory
@@ -48,6 +74,14 @@ QHash<QString, AbstractStyleDispatcher *> StyleFactory::m_dispatchers{};
     All process described above is automatically done in the Control::componentComplete() method.
     No further action is required by the programmer to complete this task.
 
+    \subsection incremental_creation Incremental Creation
+
+    When a control is created asynchronously, e.g., by a \c Loader with the \c asynchronous
+    property set to \c true, the creation of a style is split into resumable steps with
+    createIncrementally(). Each step creates a single style state operation and is processed by the
+    StyleScheduler so that the creation does not block the user interface. The controls of the same
+    signature created in the meantime are mapped to the style once the creation is finished.
+
     \subsection control_signature Control's signature
 
     The StyleFactory class uses the concept of control's signature in order to determine whether a
@@ -78,12 +112,42 @@ QHash<QString, AbstractStyleDispatcher *> StyleFactory::m_dispatchers{};
 
     The control's signature for the control above will be <tt>Stoiridh.Controls.Private/Button</tt>.
 
+    Since looking up the control's signature locks the QML meta-type registry, the style dispatchers
+    are also cached by type, so that the creation of a control whose type is already known neither
+    locks the registry nor hashes its signature. The type of a control is identified by its
+    meta-object, or, if the control declares properties in QML and has thus a meta-object of its
+    own, by the property cache shared by the instances of its QML declaration.
+
     \subsection memory_handling Memory Handling
 
     Each time a style is created from the StyleFactory, the style is associated with an
     AbstractStyleDispatcher. The AbstractStyleDispatcher created is handled by the StyleFactory and
     will be automatically destroyed when the user will quit the application.
 
+    \subsection engines_and_threads QML Engines and Threads
+
+    The styles are registered per QML engine, a style being never shared between the controls of
+    two QML engines. Thus, several QML engines can live in their own thread: the registries are
+    looked up under a lock, whereas the content of a registry is only accessed from the thread of
+    its QML engine. The registry of a QML engine is destroyed with it, provided that the engine is
+    initialised with Bootstrap::QmlExtensionPlugin::init(). The controls created outside of a QML
+    engine are registered per thread.
+
+    The steps of an incremental creation are bound to the registry that was current when they have
+    been posted, so that they are discarded if their QML engine is destroyed in the meantime, even
+    though another QML engine is allocated at the same address.
+
+    \subsection teardown Teardown
+
+    A control destroyed while its style lives removes its mappings from the style, one expression
+    at a time. When the registry of a QML engine is destroyed before the scene, the controls find
+    their style destroyed and have nothing to remove. Hence, the registry of a QML engine
+    initialised with Bootstrap::QmlExtensionPlugin::init() is destroyed as soon as the application
+    is about to quit, i.e., before the QML engine destroys its root objects.
+
+    The objects of the compiled styles are always destroyed, so that nothing they hold, e.g., the
+    mappings of the controls to their targets, outlives the QML engine.
+
     \subsection activity_diagram Activity Diagram
 
     The activity diagram below shows the working process of the style factory when the QML engine
@@ -96,14 +160,391 @@ QHash<QString, AbstractStyleDispatcher *> StyleFactory::m_dispatchers{};
 
 
 /*!
+    Creates ahead of time the styles of the controls held by the given \a components and returns
+    the started StyleWarmUp with the given \a parent.
+
+    The StyleWarmUp::finished() signal is emitted once the styles are created and registered within
+    the style factory.
+
+    \sa StyleWarmUp
+*/
+StyleWarmUp *StyleFactory::warmUp(const QList<QQmlComponent *> &components, QObject *parent)
+{
+    auto *const warmUp = new StyleWarmUp{parent};
+    warmUp->setComponents(components);
+    warmUp->start();
+
+    return warmUp;
+}
+
+/*!
+    Returns the style dispatchers registered in the style factory for the QML \a engine by
+    control's signature.
+
+    A null \a engine refers to the controls created outside of a QML engine from the calling
+    thread.
+*/
+QHash<QString, AbstractStyleDispatcher *> StyleFactory::dispatchers(const QQmlEngine *engine)
+{
+    auto *const registry = findRegistry(engine);
+    return registry ? registry->dispatchers : QHash<QString, AbstractStyleDispatcher *>{};
+}
+
+/*!
+    \internal
+
+    Returns the style dispatchers cached in the style factory for the QML \a engine by control's
+    type, i.e., by meta-object or by property cache.
+
+    A null \a engine refers to the controls created outside of a QML engine from the calling
+    thread.
+*/
+QHash<const void *, AbstractStyleDispatcher *> StyleFactory::types(const QQmlEngine *engine)
+{
+    auto *const registry = findRegistry(engine);
+    return registry ? registry->types : QHash<const void *, AbstractStyleDispatcher *>{};
+}
+
+/*!
+    Destroys the style dispatchers created from the style factory for the QML \a engine.
+
+    A null \a engine refers to the controls created outside of a QML engine from the calling
+    thread.
+
+    \note This method must be called from the thread of the QML \a engine.
+
+    \sa {teardown}{Teardown}
+*/
+void StyleFactory::destroy(const QQmlEngine *engine)
+{
+    const auto key = registryKey(engine);
+    Registry *registry{nullptr};
+
+    {
+        QMutexLocker locker{&m_mutex};
+        registry = m_registries.take(key);
+    }
+
+    destroyRegistry(registry);
+}
+
+/*!
+    \overload
+
     Destroys all style dispatchers created from the style factory.
 
-    \note Generally, you will never call this method.
+    \note Generally, you will never call this method. Since the style dispatchers of a QML engine
+    are destroyed from the calling thread, all the QML engines must live in that thread.
 */
 void StyleFactory::destroy()
 {
-    qDeleteAll(m_dispatchers);
-    m_dispatchers.clear();
+    QHash<RegistryKey, Registry *> registries{};
+
+    {
+        QMutexLocker locker{&m_mutex};
+        registries.swap(m_registries);
+    }
+
+    for (auto *const registry : registries)
+    {
+        destroyRegistry(registry);
+    }
+}
+
+/*!
+    \internal
+
+    Returns the key of the registry of the QML \a engine.
+
+    The registry of a null \a engine is not shared between the threads, since the content of a
+    registry is only accessed from a single thread.
+*/
+StyleFactory::RegistryKey StyleFactory::registryKey(const QQmlEngine *engine)
+{
+    return RegistryKey{engine, engine ? nullptr : QThread::currentThread()};
+}
+
+/*!
+    \internal
+
+    Returns the registry of the QML \a engine, which is created if it does not exist yet.
+*/
+StyleFactory::Registry *StyleFactory::registry(const QQmlEngine *engine)
+{
+    const auto key = registryKey(engine);
+
+    QMutexLocker locker{&m_mutex};
+    auto &registry = m_registries[key];
+
+    if (!registry)
+    {
+        registry = new Registry{};
+        registry->generation = ++m_generation;
+    }
+
+    return registry;
+}
+
+/*!
+    \internal
+
+    Returns the registry of the QML \a engine, or nullptr if it does not exist.
+*/
+StyleFactory::Registry *StyleFactory::findRegistry(const QQmlEngine *engine)
+{
+    const auto key = registryKey(engine);
+
+    QMutexLocker locker{&m_mutex};
+    return m_registries.value(key);
+}
+
+/*!
+    \internal
+    \overload
+
+    Returns the registry of the QML \a engine, or nullptr if it does not exist or if it is not the
+    registry of the given \a generation, i.e., the QML \a engine has been destroyed and another one
+    has been allocated at the same address.
+*/
+StyleFactory::Registry *StyleFactory::findRegistry(const QQmlEngine *engine, quint64 generation)
+{
+    auto *const registry = findRegistry(engine);
+    return (registry && registry->generation == generation) ? registry : nullptr;
+}
+
+/*!
+    \internal
+
+    Destroys the \a registry and its style dispatchers.
+*/
+void StyleFactory::destroyRegistry(Registry *registry)
+{
+    if (!registry)
+        return;
+
+    registry->tasks.clear();
+    registry->types.clear();
+
+    for (auto *const propertyCache : registry->propertyCaches)
+    {
+        propertyCache->release();
+    }
+
+    qDeleteAll(registry->dispatchers);
+
+    delete registry;
+}
+
+/*!
+    \internal
+
+    Returns the style dispatcher registered in the \a registry for the type of the \a control, or
+    nullptr if none is registered.
+
+    The control's signature is only looked up through the \a helper the first time a type is seen,
+    in which case it is stored in \a id, so that it is not looked up again to register a new style
+    dispatcher.
+*/
+AbstractStyleDispatcher *StyleFactory::findDispatcher(Registry *registry, const Control *control,
+                                                      const StyleFactoryHelper &helper, QString *id)
+{
+    if (auto *const dispatcher = registry->types.value(typeOf(control)))
+        return dispatcher;
+
+    *id = helper.controlId();
+    auto *const dispatcher = registry->dispatchers.value(*id);
+
+    if (dispatcher)
+        insertDispatcher(registry, control, QString{}, dispatcher);
+
+    return dispatcher;
+}
+
+/*!
+    \internal
+
+    Registers the \a dispatcher in the \a registry for the control's signature \a id, unless
+    \a id is empty, and for the type of the \a control.
+
+    A property cache is retained until the \a registry is destroyed, so that its address can't be
+    reused by another type in the meantime.
+*/
+void StyleFactory::insertDispatcher(Registry *registry, const Control *control, const QString &id,
+                                    AbstractStyleDispatcher *dispatcher)
+{
+    if (!id.isEmpty())
+        registry->dispatchers.insert(id, dispatcher);
+
+    const auto *const type = typeOf(control);
+
+    if (!type || registry->types.contains(type))
+        return;
+
+    if (type != control->metaObject())
+    {
+        auto *const propertyCache = QQmlData::get(control)->propertyCache;
+        propertyCache->addref();
+        registry->propertyCaches.append(propertyCache);
+    }
+
+    registry->types.insert(type, dispatcher);
+}
+
+/*!
+    \internal
+
+    Maps the style of the \a control to the style held by the \a dispatcher.
+
+    \return true if the mapping is successful, otherwise, false.
+*/
+bool StyleFactory::reuse(const Control *control, StyleFactoryHelper *helper,
+                         AbstractStyleDispatcher *dispatcher)
+{
+    helper->setStyleDispatcher(dispatcher);
+
+    if (!helper->mapping())
+    {
+        QString message = QString::fromUtf8("StyleFactory: %1\n%2\n    %3")
+                .arg(QObject::tr("An error has occurred during mapping styles."))
+                .arg(QObject::tr("Errors:"))
+                .arg(helper->mappingErrors());
+
+        QtQml::qmlInfo(control) << message;
+        StyleStatistics::recordFailedMapping();
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+    \internal
+
+    Requests the style of the \a control. The style dispatcher is created by the given \a factory
+    when the control's signature is not registered yet.
+
+    \throw NullPointerException if \a control is null.
+*/
+void StyleFactory::createIncrementally(Control *control,
+                                       StyleFactoryTask::DispatcherFactory &&factory,
+                                       Callback &&callback)
+{
+    if (!ExceptionHandler::checkNullPointer(control,
+                                            QStringLiteral("control"),
+                                            QStringLiteral("Control *")))
+        return;
+
+    const QString id = StyleFactoryHelper{control}.controlId();
+    const auto *const engine = QtQml::qmlEngine(control);
+    auto *const registry = StyleFactory::registry(engine);
+
+    if (registry->dispatchers.contains(id))
+    {
+        postReuse(engine, registry->generation, id, control, std::move(callback));
+        return;
+    }
+
+    // the first control of a signature starts the task, the next ones wait for its completion.
+    auto &task = registry->tasks[id];
+
+    if (!task)
+    {
+        task = QSharedPointer<StyleFactoryTask>::create(std::move(factory));
+        postTask(engine, registry->generation, id);
+    }
+
+    task->addRequest(control, std::move(callback));
+}
+
+/*!
+    \internal
+
+    Posts the next step of the task \a id of the registry of the given \a generation of the QML
+    \a engine to the style scheduler.
+*/
+void StyleFactory::postTask(const QQmlEngine *engine, quint64 generation, const QString &id)
+{
+    StyleScheduler::instance()->post([engine, generation, id]() {
+        processTask(engine, generation, id);
+    });
+}
+
+/*!
+    \internal
+
+    Processes the next step of the task \a id of the registry of the given \a generation of the
+    QML \a engine. Once the task is finished, the style dispatcher is registered and the requests
+    of the task are fulfilled.
+*/
+void StyleFactory::processTask(const QQmlEngine *engine, quint64 generation, const QString &id)
+{
+    auto *const registry = findRegistry(engine, generation);
+
+    // the task has been discarded by destroy().
+    if (!registry)
+        return;
+
+    auto task = registry->tasks.value(id);
+
+    if (!task)
+        return;
+
+    if (task->step())
+    {
+        postTask(engine, generation, id);
+        return;
+    }
+
+    registry->tasks.remove(id);
+
+    if (task->isEmpty())
+        return;
+
+    auto requests = task->takeRequests();
+
+    // a control of the same signature may have created the style synchronously in the meantime.
+    if (registry->dispatchers.contains(id))
+    {
+        for (auto &request : requests)
+            postReuse(engine, generation, id, request.control, std::move(request.callback));
+
+        return;
+    }
+
+    auto *const dispatcher = task->createStyleDispatcher();
+    registry->dispatchers[id] = dispatcher;
+
+    auto owner = requests.takeFirst();
+    owner.callback(dispatcher->style());
+
+    for (auto &request : requests)
+        postReuse(engine, generation, id, request.control, std::move(request.callback));
+}
+
+/*!
+    \internal
+
+    Posts the mapping of the \a control to the style registered for the signature \a id within
+    the registry of the given \a generation of the QML \a engine. The \a callback is invoked with
+    the style once the mapping is done.
+*/
+void StyleFactory::postReuse(const QQmlEngine *engine, quint64 generation, const QString &id,
+                             Control *control, Callback &&callback)
+{
+    auto reuseStyle = [engine, generation, id, control, callback]()
+    {
+        auto *const registry = findRegistry(engine, generation);
+        auto *const dispatcher = registry ? registry->dispatchers.value(id) : nullptr;
+
+        if (!dispatcher)
+            return;
+
+        StyleFactoryHelper helper{control};
+        reuse(control, &helper, dispatcher);
+        callback(dispatcher->style());
+    };
+
+    StyleScheduler::instance()->post(control, std::move(reuseStyle));
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -121,6 +562,21 @@ void StyleFactory::destroy()
     \throw NullPointerException if \a control is null.
 */
 
+/*! \fn void StyleFactory::createIncrementally(Control *control, Callback &&callback)
+
+    Creates incrementally a style for a \a control. The \a callback is invoked with the style of
+    the \a control once created.
+
+    The creation is spread over several frames by the StyleScheduler; the \a callback will not be
+    invoked if the \a control is destroyed in the meantime.
+
+    \tparam T must be a base of AbstractStyleDispatcher.
+
+    \pre the \a control must have a non-null style.
+
+    \throw NullPointerException if \a control is null.
+*/
+
 //--------------------------------------------------------------------------------------------------
 } // namespace StoiridhControlsTemplates
 //--------------------------------------------------------------------------------------------------
@@ -38,32 +38,96 @@
 #include "core/exception/exceptionhandler.hpp"
 
 #include "api/internal/global.hpp"
+#include "api/internal/diagnostics/styleprofilerrange.hpp"
+#include "api/internal/diagnostics/styletracerecorder.hpp"
 #include "api/internal/style/abstractstyledispatcher.hpp"
 #include "api/internal/style/utility/stylefactoryhelper.hpp"
+#include "api/internal/style/utility/stylefactorytask.hpp"
 
 #include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QPair>
 #include <QtCore/QScopedPointer>
+#include <QtCore/QSharedPointer>
 #include <QtCore/QString>
+#include <QtCore/QVector>
+#include <QtQml/QQmlEngine>
 #include <QtQml/QQmlInfo>
 
 #include <type_traits>
 
+QT_BEGIN_NAMESPACE
+class QQmlComponent;
+class QQmlPropertyCache;
+class QThread;
+QT_END_NAMESPACE
+
 //--------------------------------------------------------------------------------------------------
 namespace StoiridhControlsTemplates {
 //--------------------------------------------------------------------------------------------------
 
 class Style;
+class StyleWarmUp;
 
 class SCT_INTERNAL_API StyleFactory final
 {
+public:
+    using Callback = StyleFactoryTask::Callback;
+
 public:
     template<typename T>
     static Style *create(const Control *control) Q_REQUIRED_RESULT;
 
+    template<typename T>
+    static void createIncrementally(Control *control, Callback &&callback);
+
+    static StyleWarmUp *warmUp(const QList<QQmlComponent *> &components,
+                               QObject *parent = nullptr);
+
+    static QHash<QString, AbstractStyleDispatcher *> dispatchers(const QQmlEngine *engine);
+    static QHash<const void *, AbstractStyleDispatcher *> types(const QQmlEngine *engine);
+
+    static void destroy(const QQmlEngine *engine);
     static void destroy();
 
 private:
-    static QHash<QString, AbstractStyleDispatcher *> m_dispatchers;
+    struct Registry
+    {
+        QHash<QString, AbstractStyleDispatcher *> dispatchers{};
+        QHash<QString, QSharedPointer<StyleFactoryTask>> tasks{};
+        QHash<const void *, AbstractStyleDispatcher *> types{};
+        QVector<QQmlPropertyCache *> propertyCaches{};
+        quint64 generation{};
+    };
+
+    using RegistryKey = QPair<const QQmlEngine *, const QThread *>;
+
+    static RegistryKey registryKey(const QQmlEngine *engine);
+    static Registry *registry(const QQmlEngine *engine);
+    static Registry *findRegistry(const QQmlEngine *engine);
+    static Registry *findRegistry(const QQmlEngine *engine, quint64 generation);
+    static void destroyRegistry(Registry *registry);
+
+    static AbstractStyleDispatcher *findDispatcher(Registry *registry, const Control *control,
+                                                   const StyleFactoryHelper &helper, QString *id);
+    static void insertDispatcher(Registry *registry, const Control *control, const QString &id,
+                                 AbstractStyleDispatcher *dispatcher);
+
+    static bool reuse(const Control *control, StyleFactoryHelper *helper,
+                      AbstractStyleDispatcher *dispatcher);
+
+    static void createIncrementally(Control *control, StyleFactoryTask::DispatcherFactory &&factory,
+                                    Callback &&callback);
+    static void postTask(const QQmlEngine *engine, quint64 generation, const QString &id);
+    static void processTask(const QQmlEngine *engine, quint64 generation, const QString &id);
+    static void postReuse(const QQmlEngine *engine, quint64 generation, const QString &id,
+                          Control *control, Callback &&callback);
+
+private:
+    static QHash<RegistryKey, Registry *> m_registries;
+    static quint64 m_generation;
+    static QMutex m_mutex;
 };
 
 //--------------------------------------------------------------------------------------------------
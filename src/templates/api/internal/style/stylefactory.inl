@@ -26,43 +26,48 @@ Style *StyleFactory::create(const Control *control)
 {
     static_assert(std::is_base_of<AbstractStyleDispatcher, T>::value,
                   "T is not a base of AbstractStyleDispatcher");
-    ExceptionHandler::checkNullPointer(control,
-                                       QStringLiteral("control"),
-                                       QStringLiteral("const Control *"));
 
-    QScopedPointer<StyleFactoryHelper> helper{new StyleFactoryHelper{control}};
-    AbstractStyleDispatcher *dispatcher{nullptr};
+    if (!ExceptionHandler::checkNullPointer(control,
+                                            QStringLiteral("control"),
+                                            QStringLiteral("const Control *")))
+        return nullptr;
+
+    StyleProfilerRange range{control, [control]() {
+        return QStringLiteral("StyleFactory::create %1").arg(StyleProfilerRange::typeName(control));
+    }};
+    StyleTraceScope scope{"StyleFactory::create", StyleTraceRecorder::Category::Factory, control};
 
-    const auto id = helper->controlId();
+    QScopedPointer<StyleFactoryHelper> helper{new StyleFactoryHelper{control}};
+    auto *const registry = StyleFactory::registry(QtQml::qmlEngine(control));
+    QString id{};
+    auto *dispatcher = findDispatcher(registry, control, *helper, &id);
 
     // a style dispatcher is already registered for a control type.
-    if (m_dispatchers.contains(id))
+    if (dispatcher)
     {
-        dispatcher = m_dispatchers.value(id);
-
-        helper->setStyleDispatcher(dispatcher);
-
-        if (!helper->mapping())
-        {
-            QString message = QString::fromUtf8("StyleFactory: %1\n%2\n    %3")
-                    .arg(QObject::tr("An error has occurred during mapping styles."))
-                    .arg(QObject::tr("Errors:"))
-                    .arg(helper->mappingErrors());
-
-            QtQml::qmlInfo(control) << message;
-        }
+        reuse(control, helper.data(), dispatcher);
     }
     else
     {
         helper->createStyleStatesOperations();
 
         dispatcher = new T{helper->style()};
-        m_dispatchers[id] = dispatcher;
+        insertDispatcher(registry, control, id, dispatcher);
     }
 
     return dispatcher->style();
 }
 
+template<typename T>
+void StyleFactory::createIncrementally(Control *control, Callback &&callback)
+{
+    static_assert(std::is_base_of<AbstractStyleDispatcher, T>::value,
+                  "T is not a base of AbstractStyleDispatcher");
+
+    auto factory = [](Style *style) -> AbstractStyleDispatcher * { return new T{style}; };
+    createIncrementally(control, factory, std::move(callback));
+}
+
 //--------------------------------------------------------------------------------------------------
 } // namespace StoiridhControlsTemplates
 //--------------------------------------------------------------------------------------------------
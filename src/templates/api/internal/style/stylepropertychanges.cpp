@@ -18,6 +18,8 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #include "stylepropertychanges.hpp"
 
+#include "api/internal/diagnostics/styletracerecorder.hpp"
+
 #include "api/private/style/stylepropertychanges_p.hpp"
 
 #include <QtQml/QQmlInfo>
@@ -166,8 +168,13 @@ void StylePropertyChangesPrivate::applyBindings(QQmlCompiledData *data, const Bi
             value = binding->valueAsString(unit);
             break;
         case Binding::Type_GroupProperty:
+        {
+            // only the outermost call is traced, decodeGroupPropertyBindings() being recursive.
+            StyleTraceScope scope{"StylePropertyChangesPrivate::decodeGroupPropertyBindings",
+                                  StyleTraceRecorder::Category::Parser, q_func()};
             decodeGroupPropertyBindings(QString{}, unit, binding);
             break;
+        }
         // StylePropertyChanges supports only one-way to source - target - binding.
         case Binding::Type_Invalid:
         case Binding::Type_Translation:
@@ -246,7 +253,7 @@ void StylePropertyChangesPrivate::decode()
 {
     Q_Q(StylePropertyChanges);
 
-    for (const auto &property : properties)
+    for (auto &property : properties)
     {
         QQmlProperty p{target, property.first, QtQml::qmlContext(q)};
 
@@ -259,6 +266,18 @@ void StylePropertyChangesPrivate::decode()
             }
             else
             {
+                // the values are typed ahead of time, so that a value is interned once with the
+                // type of its property, e.g., a colour as a QColor instead of a string.
+                const int type = p.propertyType();
+
+                if (type != QMetaType::QVariant && property.second.userType() != type)
+                {
+                    auto value = property.second;
+
+                    if (value.convert(type))
+                        property.second = value;
+                }
+
                 // p.name() doesn't take into account the fully qualified attached-property name
                 // like 'border.width' instead it will return only 'width' as attached-property
                 // name.
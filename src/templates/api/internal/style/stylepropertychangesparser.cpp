@@ -18,6 +18,8 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #include "stylepropertychangesparser.hpp"
 
+#include "api/internal/diagnostics/styletracerecorder.hpp"
+
 #include "api/private/style/stylepropertychanges_p.hpp"
 
 #include <QtCore/QObject>
@@ -57,6 +59,9 @@ namespace StoiridhControlsTemplates {
 void StylePropertyChangesParser::verifyBindings(const Unit *unit,
                                                 const QList<const Binding *> &bindings)
 {
+    StyleTraceScope scope{"StylePropertyChangesParser::verifyBindings",
+                          StyleTraceRecorder::Category::Parser, this};
+
     for (const auto *binding : bindings)
     {
         if (binding)
@@ -95,6 +100,9 @@ void StylePropertyChangesParser::verifyBindings(const Unit *unit,
 void StylePropertyChangesParser::applyBindings(QObject *object, QQmlCompiledData *data,
                                                const QList<const QV4::CompiledData::Binding *> &bindings)
 {
+    StyleTraceScope scope{"StylePropertyChangesParser::applyBindings",
+                          StyleTraceRecorder::Category::Parser, object};
+
     auto *const stylePropertyChanges = qobject_cast<StylePropertyChanges *>(object);
 
     if (stylePropertyChanges)
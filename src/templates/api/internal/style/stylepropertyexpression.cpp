@@ -21,10 +21,16 @@
 #include "control.hpp"
 #include "core/exception/exceptionhandler.hpp"
 
+#include "api/internal/diagnostics/stylestatistics.hpp"
+#include "api/internal/diagnostics/stylewriteprofiler.hpp"
+
 #include <QtQml/QQmlProperty>
 #include <QtQuick/QQuickItem>
 
-#include <stdexcept>
+#include <QtCore/private/qmetaobject_p.h>
+#include <QtQml/private/qqmldata_p.h>
+
+#include <algorithm>
 
 //--------------------------------------------------------------------------------------------------
 namespace StoiridhControlsTemplates {
@@ -33,12 +39,67 @@ namespace StoiridhControlsTemplates {
 static const
 QString &propertyEmptyMessage = QObject::tr("A property can't be an empty string.");
 
+// returns the position of the name property in the sorted properties, or the position where it
+// would be inserted.
+template<typename Properties>
+static auto findProperty(Properties &properties, const QString &name) noexcept
+{
+    return std::lower_bound(properties.begin(), properties.end(), name,
+                            [](const auto &property, const QString &key) {
+        return property.first < key;
+    });
+}
+
+// returns the meta-object of the type of target, i.e., the first meta-object that is not the
+// dynamic meta-object of its QML-declared properties.
+static const QMetaObject *metaObjectOf(const QObject *target) noexcept
+{
+    auto *metaObject = target->metaObject();
+
+    while (metaObject && (QMetaObjectPrivate::get(metaObject)->flags & DynamicMetaObject))
+        metaObject = metaObject->superClass();
+
+    return metaObject;
+}
+
+// writes value to the property at index of target, or, if the property is not a property of the
+// type of target, e.g., a property declared in QML, to the property named name.
+static bool writeProperty(const Control *control, QQuickItem *target, int index,
+                          const QString &name, const QVariant &value)
+{
+    const auto *const data = QQmlData::get(target);
+
+    // QQmlProperty::write() removes the binding of the property, if any.
+    if (index >= 0 && !(data && data->hasBindingBit(index)))
+    {
+        const auto property = target->metaObject()->property(index);
+
+        if (!property.isWritable())
+            return false;
+
+        property.write(target, value);
+        return true;
+    }
+
+    QQmlProperty property{target, name, QtQml::qmlContext(control)};
+
+    if (!(property.isValid() && property.isWritable()))
+        return false;
+
+    property.write(value);
+    return true;
+}
+
 
 /*! \class StylePropertyExpression
     \since StoiridhControlsTemplates 1.0
     \ingroup style
 
     \brief The StylePropertyExpression class represents an expression for a StyleStateOperation.
+
+    The values of the properties are interned in the constant pool of StyleValue, so an expression
+    only stores the index of each value and two expressions are compared without comparing their
+    values.
 */
 
 
@@ -60,9 +121,11 @@ StylePropertyExpression::StylePropertyExpression(const StylePropertyExpression &
 StylePropertyExpression::StylePropertyExpression(StylePropertyExpression &&rhs) noexcept
     : m_mappings(std::move(rhs.m_mappings))
     , m_properties(std::move(rhs.m_properties))
+    , m_propertyIndexes(std::move(rhs.m_propertyIndexes))
 {
     rhs.m_mappings.clear();
     rhs.m_properties.clear();
+    rhs.m_propertyIndexes.clear();
 }
 
 /*!
@@ -91,7 +154,9 @@ bool StylePropertyExpression::containsTarget(const Control *control, const QQuic
     if (!(control && target))
         return false;
 
-    return (*m_mappings.constFind(control)) == target;
+    const auto cit = m_mappings.constFind(control);
+
+    return cit != m_mappings.cend() && cit.value() == target;
 }
 
 /*!
@@ -101,12 +166,15 @@ bool StylePropertyExpression::containsTarget(const Control *control, const QQuic
 */
 void StylePropertyExpression::addMapping(const Control *control, QQuickItem *target)
 {
-    ExceptionHandler::checkNullPointer(control,
-                                       QStringLiteral("control"),
-                                       QStringLiteral("const Control *"));
-    ExceptionHandler::checkNullPointer(target,
-                                       QStringLiteral("target"),
-                                       QStringLiteral("QQuickItem *"));
+    if (!ExceptionHandler::checkNullPointer(control,
+                                            QStringLiteral("control"),
+                                            QStringLiteral("const Control *")))
+        return;
+
+    if (!ExceptionHandler::checkNullPointer(target,
+                                            QStringLiteral("target"),
+                                            QStringLiteral("QQuickItem *")))
+        return;
 
     m_mappings.insert(control, target);
 }
@@ -124,30 +192,51 @@ bool StylePropertyExpression::removeMapping(const Control *control) noexcept
     return (m_mappings.remove(control) > 0);
 }
 
+/*!
+    Returns the controls mapped in the style property expression.
+*/
+QList<const Control *> StylePropertyExpression::controls() const
+{
+    return m_mappings.keys();
+}
+
 /*!
     Returns true, if the style property expression contains an occurrence of \a name property,
     otherwise, false.
 */
 bool StylePropertyExpression::containsProperty(const QString &name) const noexcept
 {
-    return m_properties.contains(name);
+    const auto cit = findProperty(m_properties, name);
+
+    return cit != m_properties.cend() && cit->first == name;
 }
 
 /*!
     Inserts a (\a name, \a value)-pair property at the end of the style property expression.
 
+    The \a value is interned in the constant pool of StyleValue.
+
     \throw std::invalid_argument if \a name is an empty string.
 
     \sa addProperties()
 */
 void StylePropertyExpression::addProperty(const QString &name, const QVariant &value)
 {
-    if (name.isEmpty())
+    if (!ExceptionHandler::checkArgument(!name.isEmpty(), propertyEmptyMessage))
+        return;
+
+    auto it = findProperty(m_properties, name);
+
+    if (it != m_properties.end() && it->first == name)
+    {
+        it->second = StyleValue{value};
+    }
+    else
     {
-        throw std::invalid_argument{propertyEmptyMessage.toStdString()};
+        m_properties.insert(it, qMakePair(name, StyleValue{value}));
     }
 
-    m_properties.insert(name, value);
+    m_propertyIndexes.clear();
 }
 
 /*! \overload
@@ -188,7 +277,36 @@ void StylePropertyExpression::addProperties(const QVector<QPair<QString, QVarian
 */
 bool StylePropertyExpression::removeProperty(const QString &name) noexcept
 {
-    return (m_properties.remove(name) > 0);
+    auto it = findProperty(m_properties, name);
+
+    if (it == m_properties.end() || it->first != name)
+        return false;
+
+    m_properties.erase(it);
+    m_propertyIndexes.clear();
+    return true;
+}
+
+/*!
+    Returns the value of the \a name property, or an invalid StyleValue if the style property
+    expression doesn't contain the \a name property.
+*/
+StyleValue StylePropertyExpression::property(const QString &name) const noexcept
+{
+    const auto cit = findProperty(m_properties, name);
+
+    return (cit != m_properties.cend() && cit->first == name) ? cit->second : StyleValue{};
+}
+
+/*!
+    Returns the properties of the style property expression, sorted by name.
+
+    The properties are stored contiguously and, up to eight properties, within the style property
+    expression itself, so that they are written in a deterministic order.
+*/
+const StylePropertyExpression::Properties &StylePropertyExpression::properties() const noexcept
+{
+    return m_properties;
 }
 
 /*!
@@ -200,28 +318,62 @@ bool StylePropertyExpression::removeProperty(const QString &name) noexcept
     \pre \a control must be in the style property expression.
 
     \throw NullPointerException if \a control is null.
+
+    \sa applyUnchecked()
 */
 bool StylePropertyExpression::apply(const Control *control)
 {
-    ExceptionHandler::checkNullPointer(control,
-                                       QStringLiteral("control"),
-                                       QStringLiteral("const Control *"));
+    if (!ExceptionHandler::checkNullPointer(control,
+                                            QStringLiteral("control"),
+                                            QStringLiteral("const Control *")))
+        return false;
+
+    return applyUnchecked(control);
+}
+
+/*!
+    Applies the style property expression to \a control without validating it.
+
+    This function is used by the dispatch path, in which \a control has already been validated by
+    StyleDispatcher::dispatch().
+
+    Only the validation of \a control is skipped: writing the properties may still allocate memory
+    and evaluate the QML bindings that depend on them.
+
+    If \a writes is not null, the number of properties actually written is added to it, including
+    the properties written before a failed write.
+
+    \pre \a control must not be null.
+
+    \sa apply()
+*/
+bool StylePropertyExpression::applyUnchecked(const Control *control, int *writes)
+{
+    Q_ASSERT_X(control, "applyUnchecked", "control is null");
 
     auto citMappings = m_mappings.constFind(control);
 
     if (citMappings == m_mappings.end())
         return false;
 
-    for (auto cit = m_properties.cbegin(); cit != m_properties.cend(); ++cit)
+    auto *const target = citMappings.value();
+    const auto &indexes = propertyIndexes(metaObjectOf(target));
+
+    for (int i = 0; i < m_properties.count(); ++i)
     {
-        QQmlProperty property{citMappings.value(), cit.key(), QtQml::qmlContext(control)};
+        const auto &name = m_properties.at(i).first;
+        const auto value = m_properties.at(i).second.value();
+
+        StyleWriteProfiler::Scope scope{control, target, name, value};
 
-        if (property.isValid() && property.isWritable())
+        if (writeProperty(control, target, indexes.at(i), name, value))
         {
-            property.write(cit.value());
+            if (writes)
+                ++*writes;
         }
         else
         {
+            StyleStatistics::recordFailedWrite();
             return false;
         }
     }
@@ -229,6 +381,39 @@ bool StylePropertyExpression::apply(const Control *control)
     return true;
 }
 
+/*!
+    \internal
+
+    Returns the indexes of the properties in \a metaObject, in the order of the properties, or -1
+    for a property that \a metaObject doesn't declare.
+
+    The indexes are resolved on the first application to a target of the type described by
+    \a metaObject, so that the following applications to the targets of the same type don't look up
+    the properties. The values are read from the constant pool of StyleValue on each application
+    and converted by the write, hence the cache grows with the types of the targets, not with the
+    mapped controls. It is accounted for by StyleMemoryUsage.
+
+    The properties declared in QML, as well as the grouped and attached properties, are not
+    declared by \a metaObject; they are resolved by QQmlProperty on each application.
+*/
+const QVector<int> &StylePropertyExpression::propertyIndexes(const QMetaObject *metaObject)
+{
+    auto it = m_propertyIndexes.find(metaObject);
+
+    if (it != m_propertyIndexes.end())
+        return it.value();
+
+    QVector<int> indexes{};
+    indexes.reserve(m_properties.count());
+
+    for (const auto &property : m_properties)
+    {
+        indexes.append(metaObject->indexOfProperty(property.first.toLatin1().constData()));
+    }
+
+    return m_propertyIndexes.insert(metaObject, indexes).value();
+}
+
 /*!
     Copies \a rhs to \a this StylePropertyExpression instance and returns a reference to \a this
     style property expression.
@@ -239,6 +424,7 @@ StylePropertyExpression &StylePropertyExpression::operator=(const StylePropertyE
     {
         m_mappings = rhs.m_mappings;
         m_properties = rhs.m_properties;
+        m_propertyIndexes.clear();
     }
 
     return (*this);
@@ -252,9 +438,11 @@ StylePropertyExpression &StylePropertyExpression::operator=(StylePropertyExpress
 {
     m_mappings = std::move(rhs.m_mappings);
     m_properties = std::move(rhs.m_properties);
+    m_propertyIndexes = std::move(rhs.m_propertyIndexes);
 
     rhs.m_mappings.clear();
     rhs.m_properties.clear();
+    rhs.m_propertyIndexes.clear();
 
     return (*this);
 }
@@ -277,6 +465,30 @@ bool StylePropertyExpression::operator!=(const StylePropertyExpression &rhs) con
     return !(*this == rhs);
 }
 
+/*!
+    \relates StylePropertyExpression
+
+    Returns the hash value for the \a expression, using \a seed to seed the calculation.
+
+    Two expressions that compare equal have the same hash value.
+*/
+uint qHash(const StylePropertyExpression &expression, uint seed)
+{
+    uint hash{seed};
+
+    for (auto cit = expression.m_mappings.cbegin(); cit != expression.m_mappings.cend(); ++cit)
+    {
+        hash = 31 * hash + (::qHash(cit.key(), seed) ^ ::qHash(cit.value(), seed));
+    }
+
+    for (const auto &property : expression.m_properties)
+    {
+        hash = 31 * hash + (::qHash(property.first, seed) ^ qHash(property.second, seed));
+    }
+
+    return hash;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////   DOCUMENTATION    ////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -35,16 +35,20 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "api/internal/global.hpp"
+#include "api/internal/style/stylevalue.hpp"
 
 #include <QtCore/QHash>
+#include <QtCore/QList>
 #include <QtCore/QMap>
 #include <QtCore/QPair>
 #include <QtCore/QString>
+#include <QtCore/QVarLengthArray>
 #include <QtCore/QVariant>
 #include <QtCore/QVector>
 
 QT_BEGIN_NAMESPACE
 class QQuickItem;
+struct QMetaObject;
 QT_END_NAMESPACE
 
 //--------------------------------------------------------------------------------------------------
@@ -52,9 +56,14 @@ namespace StoiridhControlsTemplates {
 //--------------------------------------------------------------------------------------------------
 
 class Control;
+class StyleMemoryUsage;
 
 class SCT_INTERNAL_API StylePropertyExpression final
 {
+public:
+    using Property = QPair<QString, StyleValue>;
+    using Properties = QVarLengthArray<Property, 8>;
+
 public:
     explicit StylePropertyExpression() = default;
     StylePropertyExpression(const StylePropertyExpression &rhs);
@@ -67,14 +76,18 @@ public:
     bool containsTarget(const Control *control, const QQuickItem *target) const noexcept;
     void addMapping(const Control *control, QQuickItem *target);
     bool removeMapping(const Control *control) noexcept;
+    QList<const Control *> controls() const;
 
     bool containsProperty(const QString &name) const noexcept;
     void addProperty(const QString &name, const QVariant &value);
     void addProperty(const QPair<QString, QVariant> &property);
     void addProperties(const QVector<QPair<QString, QVariant>> &properties) noexcept;
     bool removeProperty(const QString &name) noexcept;
+    StyleValue property(const QString &name) const noexcept;
+    const Properties &properties() const noexcept;
 
     bool apply(const Control *control);
+    bool applyUnchecked(const Control *control, int *writes = nullptr);
 
     StylePropertyExpression &operator=(const StylePropertyExpression &rhs);
     StylePropertyExpression &operator=(StylePropertyExpression &&rhs) noexcept;
@@ -82,11 +95,21 @@ public:
     bool operator==(const StylePropertyExpression &rhs) const;
     bool operator!=(const StylePropertyExpression &rhs) const;
 
+    friend SCT_INTERNAL_API uint qHash(const StylePropertyExpression &expression, uint seed);
+
+private:
+    const QVector<int> &propertyIndexes(const QMetaObject *metaObject);
+
+    friend class StyleMemoryUsage;
+
 private:
     QMap<const Control *, QQuickItem *> m_mappings{};
-    QHash<QString, QVariant> m_properties{};
+    Properties m_properties{};
+    QHash<const QMetaObject *, QVector<int>> m_propertyIndexes{};
 };
 
+SCT_INTERNAL_API uint qHash(const StylePropertyExpression &expression, uint seed = 0);
+
 //--------------------------------------------------------------------------------------------------
 } // namespace StoiridhControlsTemplates
 //--------------------------------------------------------------------------------------------------
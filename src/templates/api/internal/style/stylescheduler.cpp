@@ -0,0 +1,420 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "stylescheduler.hpp"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <QtCore/QTimerEvent>
+
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickWindow>
+
+#include <algorithm>
+#include <limits>
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+namespace {
+
+// holds the style scheduler of a thread. A thread adopted by Qt never emits QThread::finished(),
+// so its style scheduler, which has no parent, is deleted when the thread exits.
+struct ThreadScheduler
+{
+    ~ThreadScheduler()
+    {
+        if (scheduler && !scheduler->parent())
+            delete scheduler.data();
+    }
+
+    QPointer<StyleScheduler> scheduler{};
+};
+
+} // namespace
+
+/*! \class StyleScheduler
+    \since StoiridhControlsTemplates 1.0
+    \ingroup style
+
+    \brief The StyleScheduler class spreads the pending style applications over several frames.
+
+    When the scheduler is enabled, the style applications are not processed immediately but queued
+    and processed at the next frame. A frame is driven by the QQuickWindow::afterAnimating() signal
+    of the exposed window of a pending control, so that the style applications are processed right
+    before the window synchronises its scene graph. When no pending control is rendered by an
+    exposed window, e.g., while the controls are incubated, an iteration of the event loop stands
+    for a frame. During a frame, the on-screen controls are processed first and the scheduler stops
+    as soon as the frame budget is exceeded; the remaining applications are carried to the next
+    frame.
+
+    Incremental work, such as the creation of a style for a control being incubated, can be posted
+    with post() and is always deferred to the next frame.
+
+    The scheduler is disabled by default and can be enabled either with setEnabled() or by setting
+    the \c SCT_STYLE_FRAME_BUDGET environment variable to a budget, in milliseconds, greater than
+    zero.
+
+    \sa lastSettleFrameCount()
+*/
+
+
+/*!
+    Constructs a style scheduler with the given \a parent.
+*/
+StyleScheduler::StyleScheduler(QObject *parent)
+    : QObject{parent}
+{
+    const auto budget = qEnvironmentVariableIntValue("SCT_STYLE_FRAME_BUDGET");
+
+    if (budget > 0)
+    {
+        m_enabled = true;
+        m_frameBudget = budget;
+    }
+}
+
+/*!
+    Returns the style scheduler of the calling thread.
+
+    Each thread has its own style scheduler, since the controls are styled in the thread of their
+    QML engine. The style scheduler of the main thread is destroyed with the application, whereas
+    the style scheduler of a QThread is destroyed once the thread is finished and the style
+    scheduler of any other thread, e.g., a thread adopted by Qt, when the thread exits.
+*/
+StyleScheduler *StyleScheduler::instance()
+{
+    static thread_local ThreadScheduler local{};
+    auto &scheduler = local.scheduler;
+
+    if (!scheduler)
+    {
+        auto *const application = QCoreApplication::instance();
+        auto *const thread = QThread::currentThread();
+
+        if (application && application->thread() == thread)
+        {
+            scheduler = new StyleScheduler{application};
+        }
+        else
+        {
+            scheduler = new StyleScheduler{};
+            QObject::connect(thread, &QThread::finished, scheduler.data(), &QObject::deleteLater);
+        }
+    }
+
+    return scheduler;
+}
+
+/*!
+    Returns true if the style scheduler defers the style applications, otherwise, false.
+*/
+bool StyleScheduler::isEnabled() const noexcept
+{
+    return m_enabled;
+}
+
+/*!
+    Sets whether the style scheduler defers the style applications to \a enabled.
+
+    \note Disabling the scheduler processes immediately the pending style applications.
+*/
+void StyleScheduler::setEnabled(bool enabled)
+{
+    if (m_enabled != enabled)
+    {
+        m_enabled = enabled;
+
+        if (!m_enabled)
+            flush();
+    }
+}
+
+/*!
+    Returns the time budget, in milliseconds, of a frame.
+*/
+int StyleScheduler::frameBudget() const noexcept
+{
+    return m_frameBudget;
+}
+
+/*!
+    Sets the time budget of a frame to \a msecs milliseconds.
+
+    \note At least one style application is processed per frame, whatever the budget.
+*/
+void StyleScheduler::setFrameBudget(int msecs) noexcept
+{
+    m_frameBudget = qMax(0, msecs);
+}
+
+/*!
+    Returns true if the style scheduler has not pending style applications, otherwise, false.
+*/
+bool StyleScheduler::isEmpty() const noexcept
+{
+    return m_entries.isEmpty();
+}
+
+/*!
+    Returns the number of pending style applications.
+*/
+int StyleScheduler::count() const noexcept
+{
+    return m_entries.count();
+}
+
+/*!
+    Returns the number of frames needed by the last burst of style applications to settle.
+
+    A frame is either a frame rendered by a window or an iteration of the event loop, see
+    \l{StyleScheduler}{the class documentation}.
+
+    \sa settled()
+*/
+int StyleScheduler::lastSettleFrameCount() const noexcept
+{
+    return m_lastSettleFrameCount;
+}
+
+/*!
+    Schedules the style application \a job of the \a item.
+
+    If the scheduler is disabled, \a job is processed immediately. The \a job will be discarded if
+    \a item is destroyed before being processed.
+*/
+void StyleScheduler::schedule(QQuickItem *item, Job &&job)
+{
+    if (!item)
+        return;
+
+    if (!m_enabled)
+    {
+        job();
+        return;
+    }
+
+    post(item, std::move(job));
+}
+
+/*!
+    Posts the \a job of the \a item to the next frame, even if the scheduler is disabled.
+
+    The \a job will be discarded if \a item is destroyed before being processed.
+
+    \sa schedule()
+*/
+void StyleScheduler::post(QQuickItem *item, Job &&job)
+{
+    if (!item)
+        return;
+
+    m_entries.append(Entry{item, std::move(job), true});
+    requestFrame(item);
+}
+
+/*!
+    \overload
+
+    Posts the \a job to the next frame. Since the \a job is not related to an item, it is always
+    processed after the jobs of the on-screen items.
+*/
+void StyleScheduler::post(Job &&job)
+{
+    m_entries.append(Entry{nullptr, std::move(job), false});
+    requestFrame(nullptr);
+}
+
+/*!
+    Processes the pending style applications until the frame budget is exceeded.
+
+    The style applications of the on-screen items are processed first.
+*/
+void StyleScheduler::processFrame()
+{
+    if (m_entries.isEmpty())
+        return;
+
+    // the frame requested from a window, if any, is processed now.
+    m_isWindowFrameRequested = false;
+    ++m_frameCount;
+
+    const auto onScreen = [](const Entry &entry) { return isOnScreen(entry.item); };
+
+    // std::stable_partition allocates a temporary buffer, so it is avoided when it is unnecessary.
+    if (!std::is_partitioned(m_entries.cbegin(), m_entries.cend(), onScreen))
+        std::stable_partition(m_entries.begin(), m_entries.end(), onScreen);
+
+    QElapsedTimer timer{};
+    timer.start();
+
+    // a job may schedule another job, thus, the entries are accessed by index.
+    int processed{};
+
+    while (processed < m_entries.count())
+    {
+        auto entry = std::move(m_entries[processed++]);
+
+        if (entry.item || !entry.isGuarded)
+            entry.job();
+
+        if (timer.elapsed() >= m_frameBudget)
+            break;
+    }
+
+    m_entries.erase(m_entries.begin(), m_entries.begin() + processed);
+
+    if (m_entries.isEmpty())
+    {
+        m_timer.stop();
+        m_lastSettleFrameCount = m_frameCount;
+        m_frameCount = 0;
+
+        emit settled(m_lastSettleFrameCount);
+    }
+    else
+    {
+        const auto it = std::find_if(m_entries.cbegin(), m_entries.cend(), [](const Entry &entry) {
+            return exposedWindow(entry.item) != nullptr;
+        });
+
+        requestFrame(it != m_entries.cend() ? it->item.data() : nullptr);
+    }
+}
+
+/*!
+    Processes all the pending style applications without regard to the frame budget.
+*/
+void StyleScheduler::flush()
+{
+    const auto budget = m_frameBudget;
+    m_frameBudget = std::numeric_limits<int>::max();
+
+    while (!m_entries.isEmpty())
+        processFrame();
+
+    m_frameBudget = budget;
+}
+
+/*! \reimp */
+void StyleScheduler::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_timer.timerId())
+    {
+        processFrame();
+        return;
+    }
+
+    QObject::timerEvent(event);
+}
+
+/*!
+    \internal
+
+    Requests the next frame for the pending style applications.
+
+    The frame is requested from the exposed window of the \a item, if any. Otherwise, the next
+    iteration of the event loop stands for a frame, unless a frame is already requested from a
+    window.
+*/
+void StyleScheduler::requestFrame(const QQuickItem *item)
+{
+    if (auto *const window = exposedWindow(item))
+    {
+        connect(window, &QQuickWindow::afterAnimating, this, &StyleScheduler::processWindowFrame,
+                Qt::UniqueConnection);
+
+        // a frame of the window processes all the pending style applications.
+        m_timer.stop();
+        m_isWindowFrameRequested = true;
+        window->update();
+    }
+    else if (!m_isWindowFrameRequested && !m_timer.isActive())
+    {
+        m_timer.start(0, this);
+    }
+}
+
+/*!
+    \internal
+
+    Processes the pending style applications when a window is about to render a frame.
+*/
+void StyleScheduler::processWindowFrame()
+{
+    if (!m_isWindowFrameRequested)
+        return;
+
+    m_isWindowFrameRequested = false;
+    processFrame();
+}
+
+/*!
+    \internal
+
+    Returns the window rendering the \a item if it is exposed, otherwise, nullptr.
+*/
+QQuickWindow *StyleScheduler::exposedWindow(const QQuickItem *item)
+{
+    auto *const window = item ? item->window() : nullptr;
+    return (window && window->isExposed()) ? window : nullptr;
+}
+
+/*!
+    \internal
+
+    Returns true if the \a item is visible and intersects the window in which it is rendered,
+    otherwise, false.
+*/
+bool StyleScheduler::isOnScreen(const QQuickItem *item)
+{
+    if (!item || !item->isVisible())
+        return false;
+
+    const auto *const window = item->window();
+
+    if (!window)
+        return false;
+
+    const QRectF windowRect{0.0, 0.0, static_cast<qreal>(window->width()),
+                                      static_cast<qreal>(window->height())};
+    const auto itemRect = item->mapRectToScene(QRectF{0.0, 0.0, item->width(), item->height()});
+
+    return windowRect.intersects(itemRect) || windowRect.contains(itemRect.topLeft());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////   DOCUMENTATION    ////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \fn StyleScheduler::~StyleScheduler() override = default
+
+    Destroys this style scheduler.
+*/
+
+/*! \fn void StyleScheduler::settled(int frameCount)
+
+    This signal is emitted when all the pending style applications have been processed.
+    \a frameCount holds the number of frames needed to settle.
+*/
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef STOIRIDHCONTROLSTEMPLATES_INTERNAL_STYLE_STYLESCHEDULER_HPP
+#define STOIRIDHCONTROLSTEMPLATES_INTERNAL_STYLE_STYLESCHEDULER_HPP
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  --------------------------------------------------------------------------------------------  //
+//  /!\                                     W A R N I N G                                    /!\  //
+//  --------------------------------------------------------------------------------------------  //
+//                                                                                                //
+//  This internal header file is not part of StoiridhControlsTemplates API. It exists purely as   //
+//  an internal use and must not be used in external project(s).                                  //
+//                                                                                                //
+//  The content of this file may change from version to version without notice, or even be        //
+//  removed.                                                                                      //
+//                                                                                                //
+//  You are forewarned!                                                                           //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "api/internal/global.hpp"
+
+#include <QtCore/QBasicTimer>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QVector>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+class QQuickItem;
+class QQuickWindow;
+QT_END_NAMESPACE
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+class SCT_INTERNAL_API StyleScheduler final : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Job = std::function<void()>;
+
+public:
+    explicit StyleScheduler(QObject *parent = nullptr);
+    ~StyleScheduler() override = default;
+
+    static StyleScheduler *instance();
+
+    bool isEnabled() const noexcept;
+    void setEnabled(bool enabled);
+
+    int frameBudget() const noexcept;
+    void setFrameBudget(int msecs) noexcept;
+
+    bool isEmpty() const noexcept;
+    int count() const noexcept;
+
+    int lastSettleFrameCount() const noexcept;
+
+    void schedule(QQuickItem *item, Job &&job);
+    void post(QQuickItem *item, Job &&job);
+    void post(Job &&job);
+    void processFrame();
+    void flush();
+
+signals:
+    void settled(int frameCount);
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    Q_DISABLE_COPY(StyleScheduler)
+
+    struct Entry
+    {
+        QPointer<QQuickItem> item{};
+        Job job{};
+        bool isGuarded{true};
+    };
+
+    static bool isOnScreen(const QQuickItem *item);
+    static QQuickWindow *exposedWindow(const QQuickItem *item);
+
+    void requestFrame(const QQuickItem *item);
+    void processWindowFrame();
+
+    QVector<Entry> m_entries{};
+    QBasicTimer m_timer{};
+    bool m_enabled{false};
+    bool m_isWindowFrameRequested{false};
+    int m_frameBudget{8};
+    int m_frameCount{};
+    int m_lastSettleFrameCount{};
+};
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
+
+#endif // STOIRIDHCONTROLSTEMPLATES_INTERNAL_STYLE_STYLESCHEDULER_HPP
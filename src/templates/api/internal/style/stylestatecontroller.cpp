@@ -25,10 +25,23 @@
 
 #include "api/private/control_p.hpp"
 
+#include <algorithm>
+
 //--------------------------------------------------------------------------------------------------
 namespace StoiridhControlsTemplates {
 //--------------------------------------------------------------------------------------------------
 
+// returns the position of the name operation in the sorted operations, or the position where it
+// would be inserted.
+template<typename Operations>
+static auto findOperation(Operations &operations, const QString &name) noexcept
+{
+    return std::lower_bound(operations.begin(), operations.end(), name,
+                            [](const auto &operation, const QString &key) {
+        return operation.first < key;
+    });
+}
+
 
 /*! \class StyleStateController
     \since StoiridhControlsTemplates 1.0
@@ -37,7 +50,20 @@ namespace StoiridhControlsTemplates {
     \brief The StyleStateController class handles the different style state operations of a
            style.
 
-    \sa Style
+    The style state operations and their style property expressions created by the
+    StyleFactoryHelper are allocated in the pool() of the style state controller, so that they are
+    released together with the controller. The controller only hands out borrowed pointers to them,
+    which remain valid as long as the controller exists.
+
+    The style state operations are stored contiguously and sorted by name, so that they are
+    looked up with a binary search and iterated in a deterministic order, the default style state
+    operation first.
+
+    Structurally identical style property expressions, i.e., with the same mappings and the same
+    properties, are allocated only once and shared by the style state operations that use them.
+    See shareExpression().
+
+    \sa Style, StylePool
 */
 
 
@@ -78,31 +104,86 @@ Style *StyleStateController::style() const
 }
 
 /*!
-    Adds a new style state \a operation at the end of the style state controller.
+    Returns the style pool in which the style state operations of the style state controller are
+    allocated.
+
+    \sa createStateOperation()
+*/
+StylePool &StyleStateController::pool() noexcept
+{
+    return m_pool;
+}
+
+/*!
+    Returns a const STL-style iterator pointing to the first (name, operation)-pair in the style
+    state controller. The pairs are sorted by name.
+
+    \sa cend()
+*/
+StyleStateController::const_iterator StyleStateController::cbegin() const
+{
+    return m_operations.cbegin();
+}
+
+/*!
+    Returns a const STL-style iterator pointing to the imaginary item after the last
+    (name, operation)-pair in the style state controller.
 
-    \sa findStateOperation(), defaultStateOperation()
+    \sa cbegin()
+*/
+StyleStateController::const_iterator StyleStateController::cend() const
+{
+    return m_operations.cend();
+}
+
+/*!
+    Creates a new style state operation with the given \a name in the pool() of the style state
+    controller and returns a pointer on it.
+
+    An operation already registered under \a name is replaced.
+
+    \sa addStateOperation(), findStateOperation()
+*/
+StyleStateOperation *StyleStateController::createStateOperation(const QString &name)
+{
+    auto *const operation = m_pool.create<StyleStateOperation>(name);
+
+    m_sharedOperations.remove(name);
+    insertStateOperation(operation);
+
+    return operation;
+}
+
+/*!
+    Adds a new style state \a operation at the end of the style state controller. The style state
+    controller shares the ownership of the \a operation.
+
+    \sa createStateOperation(), findStateOperation(), defaultStateOperation()
 */
 void
 StyleStateController::addStateOperation(QSharedPointer<StyleStateOperation> &&operation) noexcept
 {
-    m_operations[operation->name()] = std::move(operation);
+    const auto name = operation->name();
+
+    insertStateOperation(operation.data());
+    m_sharedOperations.insert(name, std::move(operation));
 }
 
 /*!
-    Finds the \a name of a style state operation and returns a weak pointer on it.
+    Finds the \a name of a style state operation and returns a pointer on it.
 
     An empty \a name means that the default style state operation will be returned.
 
-    \note If \a name was not found, a default-constructed weak pointer is returned to notice
-    there is not operation with that \a name.
+    \note If \a name was not found, a null pointer is returned to notice there is not operation
+    with that \a name.
 
     \sa defaultStateOperation()
 */
-QWeakPointer<StyleStateOperation>
-StyleStateController::findStateOperation(const QString &name) const noexcept
+StyleStateOperation *StyleStateController::findStateOperation(const QString &name) const noexcept
 {
-    return m_operations.contains(name) ? (*m_operations.find(name)).toWeakRef()
-                                       : QWeakPointer<StyleStateOperation>{};
+    const auto cit = findOperation(m_operations, name);
+
+    return (cit != m_operations.cend() && cit->first == name) ? cit->second : nullptr;
 }
 
 /*!
@@ -110,39 +191,209 @@ StyleStateController::findStateOperation(const QString &name) const noexcept
 
     \sa findStateOperation()
 */
-QWeakPointer<StyleStateOperation> StyleStateController::defaultStateOperation() const noexcept
+StyleStateOperation *StyleStateController::defaultStateOperation() const noexcept
 {
     return findStateOperation({});
 }
 
+/*!
+    Returns a style property expression equal to \a expression, allocated in the pool() of the
+    style state controller.
+
+    If an identical expression has already been shared, it is returned instead of allocating a new
+    one, so that several style state operations may hold the same expression. An expression
+    returned by this function must not be modified in place, except through
+    insertExpressionMapping() and removeMapping(), which no longer share it afterwards since its
+    hash value changes.
+
+    \sa expressionUseCount()
+*/
+StylePropertyExpression *StyleStateController::shareExpression(StylePropertyExpression &&expression)
+{
+    const auto hash = qHash(expression);
+
+    for (auto it = m_expressions.constFind(hash); it != m_expressions.cend() && it.key() == hash;
+         ++it)
+    {
+        if (*it.value() == expression)
+        {
+            ++m_expressionUses[it.value()];
+            return it.value();
+        }
+    }
+
+    auto *const shared = m_pool.create<StylePropertyExpression>(std::move(expression));
+
+    m_expressions.insert(hash, shared);
+    m_expressionUses.insert(shared, 1);
+    m_expressionHashes.insert(shared, hash);
+
+    return shared;
+}
+
+/*!
+    Returns the number of times the \a expression has been handed out by shareExpression(), or 0
+    if the \a expression was not shared by the style state controller.
+*/
+int
+StyleStateController::expressionUseCount(const StylePropertyExpression *expression) const noexcept
+{
+    return m_expressionUses.value(expression, 0);
+}
+
+/*!
+    Inserts \a mapping for the StylePropertyExpression at index position \a index in the style state
+    \a operation.
+
+    When the expression is shared with other style state operations and already maps the control
+    to another target, the expression is copied before the \a mapping is inserted, and the copy
+    replaces the expression in the \a operation only. Otherwise, this function behaves like
+    StyleStateOperation::insertExpressionMapping().
+
+    \warning \a index must be a valid index position in the style state \a operation
+             (i.e., 0 <= i < count()).
+*/
+void StyleStateController::insertExpressionMapping(StyleStateOperation *operation, int index,
+                                                   const Mapping &mapping)
+{
+    Q_ASSERT_X(operation, "insertExpressionMapping", "operation is null");
+
+    auto *expression = operation->expressionAt(index);
+
+    if (!expression || expression->containsTarget(mapping.first, mapping.second))
+        return;
+
+    if (expression->containsControl(mapping.first))
+    {
+        auto uses = m_expressionUses.find(expression);
+
+        if (uses == m_expressionUses.end() || uses.value() < 2)
+            return;
+
+        --uses.value();
+
+        expression = m_pool.create<StylePropertyExpression>(*expression);
+        m_expressionUses.insert(expression, 1);
+        operation->replaceExpression(index, expression);
+    }
+    else
+    {
+        unshareExpression(expression);
+    }
+
+    expression->addMapping(mapping.first, mapping.second);
+}
+
+/*!
+    Removes the mappings of the \a control from all the style state operations.
+
+    \note Generally, it is called when the \a control is destroyed.
+*/
+void StyleStateController::removeMapping(const Control *control) noexcept
+{
+    for (const auto &operation : m_operations)
+    {
+        for (auto cit = operation.second->cbegin(); cit != operation.second->cend(); ++cit)
+        {
+            if (*cit && (*cit)->removeMapping(control))
+                unshareExpression(*cit);
+        }
+    }
+}
+
 /*!
     Applies a style state operation to the given target \a control.
 
+    \return the number of properties written to \a control.
+
     \throw NullPointerException if \a control is null.
+
+    \sa applyUnchecked()
+*/
+int StyleStateController::apply(const Control *control)
+{
+    if (!ExceptionHandler::checkNullPointer(control,
+                                            QStringLiteral("control"),
+                                            QStringLiteral("const Control *")))
+        return 0;
+
+    return applyUnchecked(control);
+}
+
+/*!
+    Applies a style state operation to the given target \a control without validating it.
+
+    This function is used by StyleDispatcher::dispatch(), which validates \a control once for the
+    whole dispatch path.
+
+    \return the number of properties written to \a control.
+
+    \pre \a control must not be null.
+
+    \sa apply()
 */
-void StyleStateController::apply(const Control *control)
+int StyleStateController::applyUnchecked(const Control *control)
 {
-    ExceptionHandler::checkNullPointer(control,
-                                       QStringLiteral("control"),
-                                       QStringLiteral("const Control *"));
+    Q_ASSERT_X(control, "applyUnchecked", "control is null");
 
     const auto *const d_control = ControlPrivate::get(control);
-    const auto styleStateName = d_control->styleState();
-    const auto key = m_operations.contains(styleStateName) ? styleStateName : QString{};
+    const auto &styleStateName = d_control->styleState();
+
+    int writes{};
 
     // apply the default style's state before any other style's states.
-    if (auto defaultState = m_operations.value({}))
+    if (auto *const defaultState = defaultStateOperation())
     {
-        defaultState->apply(control);
+        writes += defaultState->applyUnchecked(control);
     }
 
-    if (!key.isEmpty())
+    if (!styleStateName.isEmpty())
     {
-        if (auto state = m_operations.value(key))
+        if (auto *const state = findStateOperation(styleStateName))
         {
-            state->apply(control);
+            writes += state->applyUnchecked(control);
         }
     }
+
+    return writes;
+}
+
+/*!
+    \internal
+
+    Inserts the \a operation at its sorted position, replacing the operation registered under the
+    same name, if any.
+*/
+void StyleStateController::insertStateOperation(StyleStateOperation *operation)
+{
+    const auto name = operation->name();
+    auto it = findOperation(m_operations, name);
+
+    if (it != m_operations.end() && it->first == name)
+    {
+        it->second = operation;
+    }
+    else
+    {
+        m_operations.insert(it, qMakePair(name, operation));
+    }
+}
+
+/*!
+    \internal
+
+    Removes the \a expression, which is modified in place, from the shared expressions, so that
+    shareExpression() doesn't look it up by a hash value that it no longer has.
+*/
+void StyleStateController::unshareExpression(StylePropertyExpression *expression) noexcept
+{
+    const auto hash = m_expressionHashes.find(expression);
+
+    if (hash == m_expressionHashes.end())
+        return;
+
+    m_expressions.remove(hash.value(), expression);
+    m_expressionHashes.erase(hash);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -36,10 +36,12 @@
 
 #include "api/internal/global.hpp"
 #include "api/internal/style/stylestateoperation.hpp"
+#include "api/internal/style/utility/stylepool.hpp"
 
 #include <QtCore/QHash>
 #include <QtCore/QPointer>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QVector>
 
 //--------------------------------------------------------------------------------------------------
 namespace StoiridhControlsTemplates {
@@ -50,10 +52,12 @@ class Style;
 
 class SCT_INTERNAL_API StyleStateController final
 {
-    using SSOHash = QHash<QString, QSharedPointer<StyleStateOperation>>;
+    using SSOVector = QVector<QPair<QString, StyleStateOperation *>>;
+    using Mapping = QPair<const Control *, QQuickItem *>;
 
 public:
-    using size_type = SSOHash::size_type;
+    using const_iterator = SSOVector::const_iterator;
+    using size_type = SSOVector::size_type;
 
 public:
     explicit StyleStateController(Style *style);
@@ -65,19 +69,40 @@ public:
     size_type count() const noexcept;
 
     Style *style() const;
+    StylePool &pool() noexcept;
 
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+    StyleStateOperation *createStateOperation(const QString &name = {});
     void addStateOperation(QSharedPointer<StyleStateOperation> &&operation) noexcept;
-    QWeakPointer<StyleStateOperation> findStateOperation(const QString &name) const noexcept;
-    QWeakPointer<StyleStateOperation> defaultStateOperation() const noexcept;
+    StyleStateOperation *findStateOperation(const QString &name) const noexcept;
+    StyleStateOperation *defaultStateOperation() const noexcept;
+
+    StylePropertyExpression *shareExpression(StylePropertyExpression &&expression);
+    int expressionUseCount(const StylePropertyExpression *expression) const noexcept;
+    void insertExpressionMapping(StyleStateOperation *operation, int index, const Mapping &mapping);
+
+    void removeMapping(const Control *control) noexcept;
 
-    void apply(const Control *control);
+    int apply(const Control *control);
+    int applyUnchecked(const Control *control);
 
     StyleStateController &operator=(const StyleStateController &rhs) = delete;
     StyleStateController &operator=(StyleStateController &&rhs) = delete;
 
+private:
+    void insertStateOperation(StyleStateOperation *operation);
+    void unshareExpression(StylePropertyExpression *expression) noexcept;
+
 private:
     QPointer<Style> m_style{};
-    QHash<QString, QSharedPointer<StyleStateOperation>> m_operations{};
+    StylePool m_pool{};
+    QHash<QString, QSharedPointer<StyleStateOperation>> m_sharedOperations{};
+    SSOVector m_operations{};
+    QMultiHash<uint, StylePropertyExpression *> m_expressions{};
+    QHash<const StylePropertyExpression *, int> m_expressionUses{};
+    QHash<const StylePropertyExpression *, uint> m_expressionHashes{};
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -31,6 +31,12 @@ namespace StoiridhControlsTemplates {
     \ingroup style
 
     \brief The StyleStateOperation class applies an operation to a control.
+
+    A style state operation does not own its style property expressions. The expressions of a
+    compiled style are owned by the StylePool of its StyleStateController and are only borrowed by
+    the operation, so that applying an operation doesn't touch any reference counter.
+
+    \sa StyleStateController
 */
 
 
@@ -48,6 +54,7 @@ StyleStateOperation::StyleStateOperation(const QString &name) noexcept
 StyleStateOperation::StyleStateOperation(const StyleStateOperation &rhs)
     : m_name{rhs.m_name}
     , m_expressions(rhs.m_expressions)
+    , m_sharedExpressions(rhs.m_sharedExpressions)
 {
 
 }
@@ -58,9 +65,11 @@ StyleStateOperation::StyleStateOperation(const StyleStateOperation &rhs)
 StyleStateOperation::StyleStateOperation(StyleStateOperation &&rhs) noexcept
     : m_name{std::move(rhs.m_name)}
     , m_expressions(std::move(rhs.m_expressions))
+    , m_sharedExpressions(std::move(rhs.m_sharedExpressions))
 {
     rhs.m_name.clear();
     rhs.m_expressions.clear();
+    rhs.m_sharedExpressions.clear();
 }
 
 /*!
@@ -133,6 +142,29 @@ void StyleStateOperation::setName(const QString &name)
 /*!
     Inserts \a expression at the end of the style state operation.
 
+    The \a expression is borrowed, its owner, generally the StylePool of a StyleStateController,
+    must outlive the style state operation.
+
+    Example:
+
+    \code
+    StylePool pool{};
+    StyleStateOperation operation{};
+
+    operation.addExpression(pool.create<StylePropertyExpression>());
+    \endcode
+*/
+void StyleStateOperation::addExpression(StylePropertyExpression *expression) noexcept
+{
+    m_expressions.push_back(expression);
+}
+
+/*!
+    \overload
+
+    Inserts \a expression at the end of the style state operation and shares its ownership with the
+    style state operation.
+
     Example:
 
     \code
@@ -145,7 +177,8 @@ void StyleStateOperation::setName(const QString &name)
 void
 StyleStateOperation::addExpression(QSharedPointer<StylePropertyExpression> &&expression) noexcept
 {
-    m_expressions.push_back(std::move(expression));
+    m_expressions.push_back(expression.data());
+    m_sharedExpressions.push_back(std::move(expression));
 }
 
 /*!
@@ -157,7 +190,7 @@ StyleStateOperation::addExpression(QSharedPointer<StylePropertyExpression> &&exp
 */
 void StyleStateOperation::insertExpressionMapping(int index, const Mapping &mapping)
 {
-    const auto &expression = m_expressions.at(index);
+    auto *const expression = m_expressions.at(index);
 
     if (expression && !expression->containsControl(mapping.first))
     {
@@ -166,8 +199,41 @@ void StyleStateOperation::insertExpressionMapping(int index, const Mapping &mapp
 }
 
 /*!
-    Returns a weak pointer to a StylePropertyExpression at index position \a index in the style
-    state operation.
+    Replaces the StylePropertyExpression at index position \a index by \a expression.
+
+    As with addExpression(), the \a expression is borrowed.
+
+    \warning \a index must be a valid index position in the style state operation
+             (i.e., 0 <= i < count()).
+*/
+void StyleStateOperation::replaceExpression(int index, StylePropertyExpression *expression) noexcept
+{
+    m_expressions[index] = expression;
+}
+
+/*!
+    Removes the mappings of the \a control from the style property expressions of the style state
+    operation.
+
+    \return true if at least one mapping has been removed, otherwise, false.
+*/
+bool StyleStateOperation::removeMapping(const Control *control) noexcept
+{
+    bool removed{false};
+
+    for (auto *const expression : m_expressions)
+    {
+        if (expression && expression->removeMapping(control))
+        {
+            removed = true;
+        }
+    }
+
+    return removed;
+}
+
+/*!
+    Returns the StylePropertyExpression at index position \a index in the style state operation.
 
     Example:
 
@@ -176,7 +242,7 @@ void StyleStateOperation::insertExpressionMapping(int index, const Mapping &mapp
 
     // insert expressions...
 
-    if (auto expression = operation.expressionAt(0).lock())
+    if (auto *expression = operation.expressionAt(0))
     {
         // do something with the style property expression.
     }
@@ -185,32 +251,28 @@ void StyleStateOperation::insertExpressionMapping(int index, const Mapping &mapp
     \warning \a index must be a valid index position in the style state operation
              (i.e., 0 <= i < count()).
 */
-QWeakPointer<StylePropertyExpression> StyleStateOperation::expressionAt(int index) const
+StylePropertyExpression *StyleStateOperation::expressionAt(int index) const
 {
-    return m_expressions.at(index).toWeakRef();
+    return m_expressions.at(index);
 }
 
 /*!
     Applies the style state operation to \a control.
 
-    \return true, if the style state operation is successfully applied to \a control, otherwise,
-            false.
+    \return the number of properties written to \a control.
 
     \throw NullPointerException if \a control is null.
+
+    \sa applyUnchecked()
 */
-void StyleStateOperation::apply(const Control *control)
+int StyleStateOperation::apply(const Control *control)
 {
-    ExceptionHandler::checkNullPointer(control,
-                                       QStringLiteral("control"),
-                                       QStringLiteral("const Control *"));
+    if (!ExceptionHandler::checkNullPointer(control,
+                                            QStringLiteral("control"),
+                                            QStringLiteral("const Control *")))
+        return 0;
 
-    for (const auto &expression : m_expressions)
-    {
-        if (expression)
-        {
-            expression->apply(control);
-        }
-    }
+    return applyUnchecked(control);
 }
 
 /*!
@@ -223,6 +285,7 @@ StyleStateOperation &StyleStateOperation::operator=(const StyleStateOperation &r
     {
         m_name = rhs.m_name;
         m_expressions = rhs.m_expressions;
+        m_sharedExpressions = rhs.m_sharedExpressions;
     }
 
     return (*this);
@@ -236,9 +299,11 @@ StyleStateOperation &StyleStateOperation::operator=(StyleStateOperation &&rhs) n
 {
     m_name = std::move(rhs.m_name);
     m_expressions = std::move(rhs.m_expressions);
+    m_sharedExpressions = std::move(rhs.m_sharedExpressions);
 
     rhs.m_name.clear();
     rhs.m_expressions.clear();
+    rhs.m_sharedExpressions.clear();
 
     return (*this);
 }
@@ -294,6 +359,19 @@ bool StyleStateOperation::operator!=(const StyleStateOperation &rhs) noexcept
     Returns the number of style property expressions in the style state operation.
 */
 
+/*! \fn int StyleStateOperation::applyUnchecked(const Control *control)
+
+    Applies the style state operation to \a control without validating it, and returns the number
+    of properties written to \a control.
+
+    This function is inlined in the dispatch path, in which \a control has already been validated
+    by StyleDispatcher::dispatch().
+
+    \pre \a control must not be null.
+
+    \sa apply()
+*/
+
 //--------------------------------------------------------------------------------------------------
 } // namespace StoiridhControlsTemplates
 //--------------------------------------------------------------------------------------------------
@@ -48,7 +48,7 @@ class Control;
 
 class SCT_INTERNAL_API StyleStateOperation final
 {
-    using SPEVector = QVector<QSharedPointer<StylePropertyExpression>>;
+    using SPEVector = QVector<StylePropertyExpression *>;
     using Mapping = QPair<const Control *, QQuickItem *>;
 
 public:
@@ -72,11 +72,15 @@ public:
     QString name() const;
     void setName(const QString &name);
 
+    void addExpression(StylePropertyExpression *expression) noexcept;
     void addExpression(QSharedPointer<StylePropertyExpression> &&expression) noexcept;
     void insertExpressionMapping(int index, const Mapping &mapping);
-    QWeakPointer<StylePropertyExpression> expressionAt(int index) const;
+    void replaceExpression(int index, StylePropertyExpression *expression) noexcept;
+    bool removeMapping(const Control *control) noexcept;
+    StylePropertyExpression *expressionAt(int index) const;
 
-    void apply(const Control *control);
+    int apply(const Control *control);
+    int applyUnchecked(const Control *control);
 
     StyleStateOperation &operator=(const StyleStateOperation &rhs);
     StyleStateOperation &operator=(StyleStateOperation &&rhs) noexcept;
@@ -86,7 +90,8 @@ public:
 
 private:
     QString m_name{};
-    QVector<QSharedPointer<StylePropertyExpression>> m_expressions{};
+    QVector<StylePropertyExpression *> m_expressions{};
+    QVector<QSharedPointer<StylePropertyExpression>> m_sharedExpressions{};
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -101,6 +106,24 @@ inline StyleStateOperation::size_type StyleStateOperation::count() const noexcep
     return m_expressions.count();
 }
 
+inline int StyleStateOperation::applyUnchecked(const Control *control)
+{
+    Q_ASSERT_X(control, "applyUnchecked", "control is null");
+
+    int writes{};
+
+    // a failed expression still counts the properties written before its failure.
+    for (auto *const expression : m_expressions)
+    {
+        if (expression)
+        {
+            expression->applyUnchecked(control, &writes);
+        }
+    }
+
+    return writes;
+}
+
 //--------------------------------------------------------------------------------------------------
 } // namespace StoiridhControlsTemplates
 //--------------------------------------------------------------------------------------------------
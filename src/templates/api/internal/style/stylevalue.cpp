@@ -0,0 +1,335 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "stylevalue.hpp"
+
+#include <QtCore/QMultiHash>
+#include <QtCore/QPointF>
+#include <QtCore/QReadLocker>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QRectF>
+#include <QtCore/QSize>
+#include <QtCore/QSizeF>
+#include <QtCore/QVector>
+#include <QtCore/QWriteLocker>
+#include <QtGui/QColor>
+
+#include <cstring>
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+namespace {
+
+// returns true if lhs and rhs have the same type and compare equal.
+//
+// QVariant::operator==() converts the values to compare, e.g., 1 == 1.0, so the types must be
+// checked first in order to keep the values typed. The floating-point values are compared by bit
+// pattern, so that a NaN, which never compares equal, is interned once.
+bool isIdentical(const QVariant &lhs, const QVariant &rhs)
+{
+    if (lhs.userType() != rhs.userType())
+        return false;
+
+    switch (lhs.userType())
+    {
+    case QMetaType::Float:
+    {
+        const auto l = lhs.toFloat();
+        const auto r = rhs.toFloat();
+        return std::memcmp(&l, &r, sizeof(float)) == 0;
+    }
+    case QMetaType::Double:
+    {
+        const auto l = lhs.toDouble();
+        const auto r = rhs.toDouble();
+        return std::memcmp(&l, &r, sizeof(double)) == 0;
+    }
+    default:
+        return lhs == rhs;
+    }
+}
+
+struct Registry
+{
+    int find(const QVariant &value, uint hash) const
+    {
+        for (auto cit = indexes.constFind(hash); cit != indexes.cend() && cit.key() == hash; ++cit)
+        {
+            if (isIdentical(values.at(cit.value()), value))
+                return cit.value();
+        }
+
+        return -1;
+    }
+
+    QReadWriteLock lock{};
+    QVector<QVariant> values{};
+    QMultiHash<uint, int> indexes{};
+};
+
+Q_GLOBAL_STATIC(Registry, s_registry)
+
+// combines the hash of a part of a value with the hash of its previous parts.
+uint combine(uint seed, uint hash)
+{
+    return seed ^ (hash + 0x9e3779b9u + (seed << 6) + (seed >> 2));
+}
+
+// returns the hash of the data held by a value, regardless of its type.
+uint hashOfData(const QVariant &value)
+{
+    switch (value.userType())
+    {
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Float:
+    case QMetaType::Double:
+        return ::qHash(value.toDouble());
+    case QMetaType::QColor:
+        return ::qHash(value.value<QColor>().rgba());
+    case QMetaType::QPoint:
+    case QMetaType::QPointF:
+    {
+        const auto point = value.toPointF();
+        return combine(::qHash(point.x()), ::qHash(point.y()));
+    }
+    case QMetaType::QSize:
+    {
+        const auto size = value.toSize();
+        return combine(::qHash(size.width()), ::qHash(size.height()));
+    }
+    case QMetaType::QSizeF:
+    {
+        const auto size = value.toSizeF();
+        return combine(::qHash(size.width()), ::qHash(size.height()));
+    }
+    case QMetaType::QRect:
+    case QMetaType::QRectF:
+    {
+        const auto rect = value.toRectF();
+        return combine(combine(combine(::qHash(rect.x()), ::qHash(rect.y())),
+                               ::qHash(rect.width())),
+                       ::qHash(rect.height()));
+    }
+    case QMetaType::QVariantList:
+    {
+        uint hash{0};
+
+        for (const auto &item : value.toList())
+        {
+            hash = combine(hash, hashOfData(item));
+        }
+
+        return hash;
+    }
+    case QMetaType::QVariantMap:
+    {
+        const auto map = value.toMap();
+        uint hash{0};
+
+        for (auto cit = map.cbegin(); cit != map.cend(); ++cit)
+        {
+            hash = combine(combine(hash, ::qHash(cit.key())), hashOfData(cit.value()));
+        }
+
+        return hash;
+    }
+    default:
+        // the other types that can't be converted to a string share the same bucket and are only
+        // told apart by QVariant::operator==().
+        return value.canConvert<QString>() ? ::qHash(value.toString()) : 0;
+    }
+}
+
+uint hashOf(const QVariant &value)
+{
+    return combine(static_cast<uint>(value.userType()), hashOfData(value));
+}
+
+} // namespace
+
+
+/*! \class StyleValue
+    \since StoiridhControlsTemplates 1.0
+    \ingroup style
+
+    \brief The StyleValue class is a handle on a value interned in the constant pool shared by all
+           the styles.
+
+    A theme repeats the same few colours, font sizes and radii across the states and the control
+    types of its styles. Instead of storing a QVariant for each occurrence, a
+    StylePropertyExpression stores a StyleValue, i.e., the index of the value in a process-wide
+    constant pool where identical values are stored once.
+
+    Two values are identical when they have the same type and compare equal, hence \c 1 and
+    \c 1.0 are interned separately. Comparing two style values only compares their indexes.
+
+    \code
+    StyleValue radius{QVariant{4.0}};
+    StyleValue other{QVariant{4.0}};
+
+    Q_ASSERT(radius == other);
+    Q_ASSERT(radius.value().toDouble() == 4.0);
+    \endcode
+
+    The floating-point values are compared by bit pattern, so that a NaN is interned once and
+    \c 0.0 and \c -0.0 are interned separately.
+
+    The values are never removed from the constant pool, which only grows with the distinct values
+    of the themes. Hence, the pointers to QObject, e.g., the items assigned to a property, are not
+    interned: a style value stores them directly and guards them, so that a destroyed object is
+    read as a null pointer. The pool is thread-safe, so the styles of QML engines living in
+    different threads can intern their values concurrently.
+
+    \sa StylePropertyExpression
+*/
+
+
+/*!
+    Constructs a style value by interning \a value in the constant pool.
+
+    An invalid \a value gives an invalid style value, whereas a pointer to QObject is stored by
+    the style value itself.
+*/
+StyleValue::StyleValue(const QVariant &value)
+{
+    if (!value.isValid())
+        return;
+
+    if (QMetaType::typeFlags(value.userType()) & QMetaType::PointerToQObject)
+    {
+        m_objectType = value.userType();
+        m_object = value.value<QObject *>();
+        return;
+    }
+
+    auto *const registry = s_registry();
+    const auto hash = hashOf(value);
+
+    {
+        QReadLocker locker{&registry->lock};
+        m_index = registry->find(value, hash);
+    }
+
+    if (m_index >= 0)
+        return;
+
+    QWriteLocker locker{&registry->lock};
+
+    // another thread may have interned the value between the two locks.
+    m_index = registry->find(value, hash);
+
+    if (m_index < 0)
+    {
+        m_index = registry->values.count();
+        registry->values.append(value);
+        registry->indexes.insert(hash, m_index);
+    }
+}
+
+/*!
+    Returns the type of the style value.
+
+    \sa QVariant::userType()
+*/
+int StyleValue::userType() const
+{
+    return value().userType();
+}
+
+/*!
+    Returns the value interned in the constant pool, or an invalid QVariant if the style value is
+    invalid.
+
+    A pointer to QObject is returned with its original type, or as a null pointer once the object
+    has been destroyed.
+*/
+QVariant StyleValue::value() const
+{
+    if (m_objectType != QMetaType::UnknownType)
+    {
+        auto *const object = m_object.data();
+        return QVariant{m_objectType, &object};
+    }
+
+    if (!isValid())
+        return {};
+
+    auto *const registry = s_registry();
+    QReadLocker locker{&registry->lock};
+
+    return registry->values.at(m_index);
+}
+
+/*!
+    Returns the number of values interned in the constant pool.
+*/
+int StyleValue::count()
+{
+    auto *const registry = s_registry();
+    QReadLocker locker{&registry->lock};
+
+    return registry->values.count();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////   DOCUMENTATION    ////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \fn StyleValue::StyleValue()
+
+    Constructs an invalid style value.
+*/
+
+/*! \fn bool StyleValue::isValid() const noexcept
+
+    Returns true if the style value refers to a value of the constant pool or stores a pointer to
+    QObject, otherwise, false.
+*/
+
+/*! \fn int StyleValue::index() const noexcept
+
+    Returns the index of the style value in the constant pool, or \c -1 if the style value is
+    invalid or stores a pointer to QObject.
+*/
+
+/*! \fn bool StyleValue::operator==(const StyleValue &rhs) const noexcept
+
+    Returns true if the style value refers to the same interned value as \a rhs, otherwise, false.
+*/
+
+/*! \fn bool StyleValue::operator!=(const StyleValue &rhs) const noexcept
+
+    Returns true if the style value doesn't refer to the same interned value as \a rhs, otherwise,
+    false.
+*/
+
+/*! \fn uint qHash(const StyleValue &value, uint seed = 0) noexcept
+    \relates StyleValue
+
+    Returns the hash value for the \a value, using \a seed to seed the calculation.
+*/
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
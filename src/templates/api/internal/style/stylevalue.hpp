@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef STOIRIDHCONTROLSTEMPLATES_INTERNAL_STYLE_STYLEVALUE_HPP
+#define STOIRIDHCONTROLSTEMPLATES_INTERNAL_STYLE_STYLEVALUE_HPP
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  --------------------------------------------------------------------------------------------  //
+//  /!\                                     W A R N I N G                                    /!\  //
+//  --------------------------------------------------------------------------------------------  //
+//                                                                                                //
+//  This internal header file is not part of StoiridhControlsTemplates API. It exists purely as   //
+//  an internal use and must not be used in external project(s).                                  //
+//                                                                                                //
+//  The content of this file may change from version to version without notice, or even be        //
+//  removed.                                                                                      //
+//                                                                                                //
+//  You are forewarned!                                                                           //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "api/internal/global.hpp"
+
+#include <QtCore/QPointer>
+#include <QtCore/QVariant>
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+class SCT_INTERNAL_API StyleValue final
+{
+public:
+    StyleValue() noexcept = default;
+    explicit StyleValue(const QVariant &value);
+
+    bool isValid() const noexcept;
+    int index() const noexcept;
+
+    int userType() const;
+    QVariant value() const;
+
+    static int count();
+
+    bool operator==(const StyleValue &rhs) const noexcept;
+    bool operator!=(const StyleValue &rhs) const noexcept;
+
+    friend uint qHash(const StyleValue &value, uint seed) noexcept;
+
+private:
+    int m_index{-1};
+    int m_objectType{QMetaType::UnknownType};
+    QPointer<QObject> m_object{};
+};
+
+//--------------------------------------------------------------------------------------------------
+
+inline bool StyleValue::isValid() const noexcept
+{
+    return m_index >= 0 || m_objectType != QMetaType::UnknownType;
+}
+
+inline int StyleValue::index() const noexcept
+{
+    return m_index;
+}
+
+inline bool StyleValue::operator==(const StyleValue &rhs) const noexcept
+{
+    return m_index == rhs.m_index && m_objectType == rhs.m_objectType
+            && m_object == rhs.m_object;
+}
+
+inline bool StyleValue::operator!=(const StyleValue &rhs) const noexcept
+{
+    return !(*this == rhs);
+}
+
+inline uint qHash(const StyleValue &value, uint seed = 0) noexcept
+{
+    return value.m_index >= 0 ? ::qHash(value.m_index, seed)
+                              : ::qHash(value.m_object.data(), seed);
+}
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
+
+Q_DECLARE_TYPEINFO(StoiridhControlsTemplates::StyleValue, Q_MOVABLE_TYPE);
+
+#endif // STOIRIDHCONTROLSTEMPLATES_INTERNAL_STYLE_STYLEVALUE_HPP
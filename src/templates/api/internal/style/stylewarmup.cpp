@@ -0,0 +1,287 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "stylewarmup.hpp"
+
+#include "api/internal/style/stylescheduler.hpp"
+
+#include <QtCore/QPointer>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+#include <QtQml/QQmlIncubator>
+#include <QtQml/QQmlInfo>
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+class StyleWarmUp::Incubator final : public QQmlIncubator
+{
+public:
+    Incubator(StyleWarmUp *warmUp, IncubationMode mode)
+        : QQmlIncubator{mode}
+        , m_warmUp{warmUp}
+    {
+
+    }
+
+protected:
+    void statusChanged(Status status) override
+    {
+        if (status == Ready || status == Error)
+            m_warmUp->incubated(this);
+    }
+
+private:
+    StyleWarmUp *m_warmUp{nullptr};
+};
+
+//--------------------------------------------------------------------------------------------------
+
+
+/*! \class StyleWarmUp
+    \since StoiridhControlsTemplates 1.0
+    \ingroup style
+
+    \brief The StyleWarmUp class creates the styles of a list of controls ahead of time.
+
+    The creation of the style state operations of a control's signature is done when the first
+    control of this signature is created. The StyleWarmUp class moves this cost ahead of time, e.g.,
+    during a splash screen, by creating then destroying an instance of each component. The styles
+    created remain registered within the StyleFactory for the next controls.
+
+    The instances are incubated asynchronously whenever the QML engine has an incubation
+    controller, so the style creation is spread over several frames by the StyleScheduler.
+
+    Example:
+
+    \code
+    StyleWarmUp {
+        Component { Button {} }
+        Component { CheckBox {} }
+
+        onFinished: splashScreen.close()
+    }
+    \endcode
+
+    From C++, a warm-up can be started with StyleFactory::warmUp().
+
+    \sa StyleFactory
+*/
+
+
+/*!
+    Constructs a style warm-up with the given \a parent.
+*/
+StyleWarmUp::StyleWarmUp(QObject *parent)
+    : QObject{parent}
+{
+
+}
+
+/*!
+    Destroys this style warm-up and the instances created so far.
+*/
+StyleWarmUp::~StyleWarmUp()
+{
+    clear();
+}
+
+/*! \property QQmlListProperty<QQmlComponent> StyleWarmUp::components
+
+    This default property holds the components to warm up.
+*/
+QQmlListProperty<QQmlComponent> StyleWarmUp::components()
+{
+    return {this, m_components};
+}
+
+/*!
+    Sets the \a components to warm up.
+*/
+void StyleWarmUp::setComponents(const QList<QQmlComponent *> &components)
+{
+    m_components = components;
+}
+
+/*! \property bool StyleWarmUp::running
+    \readonly
+
+    This property holds whether the style warm-up is running.
+*/
+bool StyleWarmUp::isRunning() const noexcept
+{
+    return m_running;
+}
+
+/*!
+    Starts the warm-up of the components.
+
+    The finished() signal is emitted once the styles of all components are created.
+*/
+void StyleWarmUp::start()
+{
+    if (m_running)
+        return;
+
+    m_running = true;
+    m_pendingComponents = m_components.count();
+    emit runningChanged();
+
+    auto *const scheduler = StyleScheduler::instance();
+    connect(scheduler, &StyleScheduler::settled, this, &StyleWarmUp::tryFinish);
+
+    for (auto *const component : m_components)
+    {
+        if (component && component->isLoading())
+        {
+            m_loadingComponents.insert(component);
+
+            connect(component, &QQmlComponent::statusChanged, this,
+                    [this, component](QQmlComponent::Status status)
+            {
+                if (status != QQmlComponent::Loading && m_loadingComponents.remove(component))
+                    incubate(component);
+            });
+        }
+        else
+        {
+            incubate(component);
+        }
+    }
+
+    tryFinish();
+}
+
+/*! \reimp */
+void StyleWarmUp::classBegin()
+{
+
+}
+
+/*! \reimp */
+void StyleWarmUp::componentComplete()
+{
+    start();
+}
+
+/*!
+    \internal
+
+    Incubates an instance of the \a component.
+*/
+void StyleWarmUp::incubate(QQmlComponent *component)
+{
+    if (!component || !component->isReady())
+    {
+        if (component)
+            QtQml::qmlInfo(this) << component->errorString();
+
+        --m_pendingComponents;
+        return;
+    }
+
+    // without an incubation controller, an asynchronous incubation never progresses.
+    auto *const engine = component->engine();
+    const auto mode = (engine && engine->incubationController()) ? QQmlIncubator::Asynchronous
+                                                                 : QQmlIncubator::Synchronous;
+
+    m_incubators.emplace_back(new Incubator{this, mode});
+    component->create(*m_incubators.back(), component->creationContext());
+}
+
+/*!
+    \internal
+
+    Called when the \a incubator has finished.
+*/
+void StyleWarmUp::incubated(Incubator *incubator)
+{
+    if (incubator->isError())
+    {
+        for (const auto &error : incubator->errors())
+            QtQml::qmlInfo(this) << error.toString();
+    }
+
+    --m_pendingComponents;
+
+    // the instances must not be destroyed from the incubator, thus, wait for the next frame.
+    QPointer<StyleWarmUp> self{this};
+
+    StyleScheduler::instance()->post([self]()
+    {
+        if (self)
+            self->tryFinish();
+    });
+}
+
+/*!
+    \internal
+
+    Finishes the warm-up when all instances are created and the style scheduler has settled.
+*/
+void StyleWarmUp::tryFinish()
+{
+    if (!m_running || m_pendingComponents > 0 || !StyleScheduler::instance()->isEmpty())
+        return;
+
+    disconnect(StyleScheduler::instance(), &StyleScheduler::settled,
+               this, &StyleWarmUp::tryFinish);
+
+    clear();
+
+    m_running = false;
+    emit runningChanged();
+    emit finished();
+}
+
+/*!
+    \internal
+
+    Destroys the instances created by the incubators.
+*/
+void StyleWarmUp::clear()
+{
+    for (const auto &incubator : m_incubators)
+    {
+        // the styles created remain owned by their dispatcher within the StyleFactory.
+        delete incubator->object();
+        incubator->clear();
+    }
+
+    m_incubators.clear();
+    m_loadingComponents.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////   DOCUMENTATION    ////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \fn void StyleWarmUp::finished()
+
+    This signal is emitted when the styles of all components have been created.
+*/
+
+/*! \fn void StyleWarmUp::runningChanged()
+
+    This signal is emitted when the running property changes.
+*/
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
@@ -21,6 +21,8 @@
 #include "control.hpp"
 #include "core/exception/exceptionhandler.hpp"
 
+#include "api/internal/diagnostics/styleprofilerrange.hpp"
+#include "api/internal/diagnostics/styletracerecorder.hpp"
 #include "api/internal/style/abstractstyledispatcher.hpp"
 #include "api/internal/style/style.hpp"
 #include "api/internal/style/stylepropertychanges.hpp"
@@ -33,6 +35,7 @@
 
 #include <QtQml/QQmlInfo>
 
+#include <QtCore/private/qmetaobject_p.h>
 #include <QtQml/private/qqmlmetatype_p.h>
 
 //--------------------------------------------------------------------------------------------------
@@ -81,9 +84,10 @@ namespace StoiridhControlsTemplates {
 StyleFactoryHelper::StyleFactoryHelper(const Control *control)
     : m_control{control}
 {
-    ExceptionHandler::checkNullPointer(control,
-                                       QStringLiteral("control"),
-                                       QStringLiteral("const Control *"));
+    if (!ExceptionHandler::checkNullPointer(control,
+                                            QStringLiteral("control"),
+                                            QStringLiteral("const Control *")))
+        return;
 
     // assign the style owner to the control's style
     auto *const d_control = ControlPrivate::get(control);
@@ -126,9 +130,10 @@ Style *StyleFactoryHelper::style() const
 */
 void StyleFactoryHelper::setStyleDispatcher(const AbstractStyleDispatcher *dispatcher)
 {
-    ExceptionHandler::checkNullPointer(dispatcher,
-                                       QStringLiteral("dispatcher"),
-                                       QStringLiteral("const AbstractStyleDispatcher *"));
+    if (!ExceptionHandler::checkNullPointer(dispatcher,
+                                            QStringLiteral("dispatcher"),
+                                            QStringLiteral("const AbstractStyleDispatcher *")))
+        return;
 
     // style owner (control's style) becomes the style target
     m_styleTarget = m_styleOwner;
@@ -138,62 +143,119 @@ void StyleFactoryHelper::setStyleDispatcher(const AbstractStyleDispatcher *dispa
 /*!
     Returns the control identifier. Generally, it is the result of the concatenation of the QML
     module's name and the control's name.
+
+    The properties declared in QML give a dynamic meta-object to the control, which is not
+    registered in the QML meta-type registry; the control identifier is then the one of the first
+    registered type the control derives from. An empty string is returned if the control's type is
+    not registered.
+
+    \note Looking up the control identifier locks the QML meta-type registry. The StyleFactory
+    caches the style dispatchers per type in order to avoid this lookup.
 */
-const QString &StyleFactoryHelper::controlId() const
+QString StyleFactoryHelper::controlId() const
 {
-    return QQmlMetaType::qmlType(m_control->metaObject())->qmlTypeName();
+    auto *metaObject = m_control->metaObject();
+
+    while (metaObject && (QMetaObjectPrivate::get(metaObject)->flags & DynamicMetaObject))
+        metaObject = metaObject->superClass();
+
+    const auto *const type = metaObject ? QQmlMetaType::qmlType(metaObject) : nullptr;
+    return type ? type->qmlTypeName() : QString{};
 }
 
 /*!
     Creates the different style state operations for the \e owner style state controller.
 
     \throw NullPointerException if the style \e owner (control's style) is null.
+
+    \sa createNextStyleStateOperation()
 */
 void StyleFactoryHelper::createStyleStatesOperations()
 {
-    ExceptionHandler::checkNullPointer(m_styleOwner, QStringLiteral("style owner"));
+    StyleProfilerRange range{m_control, [this]() {
+        return QStringLiteral("StyleFactoryHelper::createStyleStatesOperations %1 (%2 states)")
+                .arg(controlId())
+                .arg(m_styleOwner ? StylePrivate::get(m_styleOwner)->states.count() : 0);
+    }};
+    StyleTraceScope scope{"StyleFactoryHelper::createStyleStatesOperations",
+                          StyleTraceRecorder::Category::Factory, m_control};
+
+    while (createNextStyleStateOperation())
+    {
+    }
+}
+
+/*!
+    Creates the next style state operation for the \e owner style state controller.
+
+    The first call creates the default style state operation, then each call creates the style
+    state operation of the next style's state. This allows to spread the creation of the style
+    state operations over several steps.
+
+    \return true if style state operations remain to be created, otherwise, false.
+
+    \throw NullPointerException if the style \e owner (control's style) is null.
+
+    \sa createStyleStatesOperations()
+*/
+bool StyleFactoryHelper::createNextStyleStateOperation()
+{
+    if (!ExceptionHandler::checkNullPointer(m_styleOwner, QStringLiteral("style owner")))
+        return false;
 
     auto *d_style_owner = StylePrivate::get(m_styleOwner);
 
-    if (auto controller = d_style_owner->stateController().lock())
+    if (m_nextStyleState >= d_style_owner->states.count())
+        return false;
+
+    if (m_nextStyleState < 0)
     {
-        auto defaultOperation = createDefaultStyleStateOperation();
-        controller->addStateOperation(std::move(defaultOperation));
+        createDefaultStyleStateOperation();
+    }
+    else
+    {
+        auto *const state = d_style_owner->states.at(m_nextStyleState);
 
-        for (auto *state : d_style_owner->states)
+        if (state->name().isEmpty())
         {
-            if (state->name().isEmpty())
-            {
-                QtQml::qmlInfo(state) << QObject::tr("the name property can't be empty");
-            }
-            else
-            {
-                auto operation = createStyleStateOperation(state);
-                controller->addStateOperation(std::move(operation));
-            }
+            QtQml::qmlInfo(state) << QObject::tr("the name property can't be empty");
+        }
+        else
+        {
+            createStyleStateOperation(state);
         }
     }
+
+    return ++m_nextStyleState < d_style_owner->states.count();
 }
 
 /*!
-    Creates a new style state operation from the given \a state.
+    Creates a new style state operation from the given \a state in the state controller of the
+    style \e owner and returns a pointer on it.
+
+    The style state operation is owned by the state controller.
 
-    \throw NullPointerException if \a state is null.
+    \throw NullPointerException if either \a state or the style \e owner is null.
 */
-QSharedPointer<StyleStateOperation>
-StyleFactoryHelper::createStyleStateOperation(const StyleState *state)
+StyleStateOperation *StyleFactoryHelper::createStyleStateOperation(const StyleState *state)
 {
-    ExceptionHandler::checkNullPointer(state,
-                                       QStringLiteral("state"),
-                                       QStringLiteral("const StyleState *"));
+    if (!ExceptionHandler::checkNullPointer(state,
+                                            QStringLiteral("state"),
+                                            QStringLiteral("const StyleState *")))
+        return nullptr;
 
     auto *const d_state = StyleStatePrivate::get(state);
-    auto operation = QSharedPointer<StyleStateOperation>::create(state->name());
+    auto *const controller = stateController();
+
+    if (!controller)
+        return nullptr;
+
+    auto *const operation = controller->createStateOperation(state->name());
 
     for (auto *changes : d_state->changes)
     {
         auto expression = createStylePropertyExpression(changes);
-        operation->addExpression(std::move(expression));
+        operation->addExpression(controller->shareExpression(std::move(expression)));
     }
 
     return operation;
@@ -207,17 +269,18 @@ StyleFactoryHelper::createStyleStateOperation(const StyleState *state)
 
     \throw NullPointerException if either \a operation or \a state is null.
 */
-bool
-StyleFactoryHelper::mergeStyleStateOperation(const QSharedPointer<StyleStateOperation> &operation,
-                                             const StyleState *state)
+bool StyleFactoryHelper::mergeStyleStateOperation(StyleStateOperation *operation,
+                                                  const StyleState *state)
 {
-    ExceptionHandler::checkNullPointer(operation,
-                                       QStringLiteral("operation"),
-                                       QStringLiteral("const "
-                                                      "QSharedPointer<StyleStateOperation> &"));
-    ExceptionHandler::checkNullPointer(state,
-                                       QStringLiteral("state"),
-                                       QStringLiteral("const StyleState *"));
+    if (!ExceptionHandler::checkNullPointer(operation,
+                                            QStringLiteral("operation"),
+                                            QStringLiteral("StyleStateOperation *")))
+        return false;
+
+    if (!ExceptionHandler::checkNullPointer(state,
+                                            QStringLiteral("state"),
+                                            QStringLiteral("const StyleState *")))
+        return false;
 
     const auto *const d_state = StyleStatePrivate::get(state);
     const auto operationName = operation->name();
@@ -225,29 +288,27 @@ StyleFactoryHelper::mergeStyleStateOperation(const QSharedPointer<StyleStateOper
 
     if (operationName != styleStateName)
     {
-        pushMappingError(QObject::tr("the style state operation '%1' is not the same as the "
-                                     "given style's state '%2'.")
-                         .arg(operationName)
-                         .arg(styleStateName));
+        pushMappingError(MappingError::Code::OperationName, operationName, styleStateName);
         return false;
     }
 
     if (operation->count() != d_state->changes.count())
     {
-        pushMappingError(QObject::tr("the style state operation '%1' from the owner style are "
-                                     "not equal to the style property changes of the style's "
-                                     "state '%2' of the target style.")
-                         .arg(operationName)
-                         .arg(styleStateName));
+        pushMappingError(MappingError::Code::ExpressionsCount, operationName, styleStateName);
         return false;
     }
 
     // we need only to map the (control, target)-pair because the properties are symmetric between
     // the style state operation and the style's state.
+    auto *const controller = stateController();
+
+    if (!controller)
+        return false;
+
     for (auto i = 0; i < operation->count(); ++i)
     {
         auto *const changes = d_state->changes.at(i);
-        operation->insertExpressionMapping(i, qMakePair(m_control, changes->target()));
+        controller->insertExpressionMapping(operation, i, qMakePair(m_control, changes->target()));
     }
 
     return true;
@@ -256,27 +317,32 @@ StyleFactoryHelper::mergeStyleStateOperation(const QSharedPointer<StyleStateOper
 /*!
     Creates a new style property expression from the given \a changes.
 
+    The style property expression is not allocated in the state controller of the style \e owner
+    yet, StyleStateController::shareExpression() does it once the expression is complete, so that
+    it can be shared with the identical expressions of the other style state operations.
+
     \throw NullPointerException if \a changes is null.
 */
-QSharedPointer<StylePropertyExpression>
+StylePropertyExpression
 StyleFactoryHelper::createStylePropertyExpression(StylePropertyChanges *changes,
                                                   bool useDefaultProperties)
 {
-    ExceptionHandler::checkNullPointer(changes,
-                                       QStringLiteral("changes"),
-                                       QStringLiteral("StylePropertyChanges *"));
+    if (!ExceptionHandler::checkNullPointer(changes,
+                                            QStringLiteral("changes"),
+                                            QStringLiteral("StylePropertyChanges *")))
+        return {};
 
     auto *const d_changes = StylePropertyChangesPrivate::get(changes);
-    auto expression = QSharedPointer<StylePropertyExpression>::create();
+    StylePropertyExpression expression{};
 
     if (!d_changes->decoded)
     {
         d_changes->decode();
     }
 
-    expression->addMapping(m_control, changes->target());
-    expression->addProperties(useDefaultProperties ? d_changes->defaultProperties
-                                                   : d_changes->properties);
+    expression.addMapping(m_control, changes->target());
+    expression.addProperties(useDefaultProperties ? d_changes->defaultProperties
+                                                  : d_changes->properties);
 
     return expression;
 }
@@ -293,8 +359,19 @@ StyleFactoryHelper::createStylePropertyExpression(StylePropertyChanges *changes,
 */
 bool StyleFactoryHelper::mapping()
 {
-    ExceptionHandler::checkNullPointer(m_styleOwner, QStringLiteral("style owner"));
-    ExceptionHandler::checkNullPointer(m_styleTarget, QStringLiteral("style target"));
+    if (!ExceptionHandler::checkNullPointer(m_styleOwner, QStringLiteral("style owner")))
+        return false;
+
+    if (!ExceptionHandler::checkNullPointer(m_styleTarget, QStringLiteral("style target")))
+        return false;
+
+    StyleProfilerRange range{m_control, [this]() {
+        return QStringLiteral("StyleFactoryHelper::mapping %1 (%2 states)")
+                .arg(controlId())
+                .arg(StylePrivate::get(m_styleTarget)->states.count());
+    }};
+    StyleTraceScope scope{"StyleFactoryHelper::mapping", StyleTraceRecorder::Category::Factory,
+                          m_control};
 
     // clear the previous recorded errors
     if (m_hasErrors)
@@ -304,7 +381,7 @@ bool StyleFactoryHelper::mapping()
 
     if (m_styleOwner == m_styleTarget)
     {
-        pushMappingError(QObject::tr("style owner and style target are same."));
+        pushMappingError(MappingError::Code::SameStyles);
         return false;
     }
 
@@ -313,27 +390,25 @@ bool StyleFactoryHelper::mapping()
 
     if (d_style_owner->states.count() != d_style_target->states.count())
     {
-        pushMappingError(QObject::tr("the style's states number from the style owner are not "
-                                     "equal to the style's states number of the style target."));
+        pushMappingError(MappingError::Code::StatesCount);
         return false;
     }
 
-    if (auto controller = d_style_owner->stateController().lock())
+    if (auto *const controller = d_style_owner->stateController())
     {
         for (const auto *state : d_style_target->states)
         {
-            if (auto operation = controller->findStateOperation(state->name()).lock())
+            if (auto *const operation = controller->findStateOperation(state->name()))
             {
                 if (!mergeStyleStateOperation(operation, state))
                 {
-                    pushMappingError(QObject::tr("impossible to merge the style's state from the "
-                                                 "style target to the style state operation from "
-                                                 "the style owner."));
+                    pushMappingError(MappingError::Code::MergeState, operation->name(),
+                                     state->name());
                     return false;
                 }
             }
 
-            if (auto defaultOperation = controller->defaultStateOperation().lock())
+            if (auto *const defaultOperation = controller->defaultStateOperation())
             {
                 mergeDefaultStyleStateOperation(defaultOperation, state);
             }
@@ -353,6 +428,9 @@ bool StyleFactoryHelper::hasErrors() const noexcept
 
 /*!
     Returns the errors generated during the mapping of the styles.
+
+    The errors are recorded as codes with their arguments during the mapping and are only formatted
+    by this function.
  */
 QString StyleFactoryHelper::mappingErrors() const noexcept
 {
@@ -362,9 +440,10 @@ QString StyleFactoryHelper::mappingErrors() const noexcept
 
     while (!m_errors.empty())
     {
-        auto message = QString::fromUtf8("%1 on %2: %3\n").arg(count)
-                                                          .arg(totalErrors)
-                                                          .arg(m_errors.front());
+        auto message = QString::fromUtf8("%1 on %2: %3\n")
+                .arg(count)
+                .arg(totalErrors)
+                .arg(formatMappingError(m_errors.front()));
         errors.append(message);
         m_errors.pop();
         ++count;
@@ -374,29 +453,24 @@ QString StyleFactoryHelper::mappingErrors() const noexcept
 }
 
 /*!
-    Creates the default style state operation for the control.
+    Creates the default style state operation for the control in the state controller of the style
+    \e owner.
 
     \pre the control's style must not be null.
 */
-QSharedPointer<StyleStateOperation> StyleFactoryHelper::createDefaultStyleStateOperation()
+StyleStateOperation *StyleFactoryHelper::createDefaultStyleStateOperation()
 {
     Q_ASSERT_X(m_styleOwner, "createDefaultStyleStateOperation", "style owner is null");
 
     auto *d_style_owner = StylePrivate::get(m_styleOwner);
-    auto defaultOperation = QSharedPointer<StyleStateOperation>::create();
-
-    // check if a default style state operation contains a (control, target)-pair. If it exists,
-    // then it returns an iterator of this expression.
-    auto findExpressionByTarget = [&defaultOperation](const Control *control,
-                                                      const QQuickItem *target)
-    {
-        auto predicate = [&control, &target](const auto &expressionIterator) -> bool
-        {
-            return (*expressionIterator).containsTarget(control, target);
-        };
+    auto *const controller = stateController();
+    auto *const defaultOperation = controller->createStateOperation();
 
-        return std::find_if(std::begin(*defaultOperation), std::end(*defaultOperation), predicate);
-    };
+    // the expressions of the default style state operation are completed state after state, so
+    // they are only shared once all the style's states have been visited. Each target of the
+    // control has its own expression, indexed by the target.
+    QVector<StylePropertyExpression> expressions{};
+    QHash<const QQuickItem *, int> expressionIndexes{};
 
     for (auto *state : d_style_owner->states)
     {
@@ -410,26 +484,31 @@ QSharedPointer<StyleStateOperation> StyleFactoryHelper::createDefaultStyleStateO
 
             for (auto *changes : d_state->changes)
             {
-                auto expressionIterator = findExpressionByTarget(m_control, changes->target());
+                const auto index = expressionIndexes.value(changes->target(), -1);
 
-                if (expressionIterator != defaultOperation->end())
+                if (index != -1)
                 {
                     // add the default properties contained in the style property changes of the
                     // current style's state to the expression found.
                     auto d_changes = StylePropertyChangesPrivate::get(changes);
-                    (*expressionIterator)->addProperties(d_changes->defaultProperties);
+                    expressions[index].addProperties(d_changes->defaultProperties);
                 }
                 else
                 {
                     // create a new style property expression and append the default properties to
                     // it.
-                    auto expression = createStylePropertyExpression(changes, true);
-                    defaultOperation->addExpression(std::move(expression));
+                    expressionIndexes.insert(changes->target(), expressions.count());
+                    expressions.append(createStylePropertyExpression(changes, true));
                 }
             }
         }
     }
 
+    for (auto &expression : expressions)
+    {
+        defaultOperation->addExpression(controller->shareExpression(std::move(expression)));
+    }
+
     return defaultOperation;
 }
 
@@ -439,30 +518,48 @@ QSharedPointer<StyleStateOperation> StyleFactoryHelper::createDefaultStyleStateO
     \pre \a operation must not be null.
     \pre \a state must not be null.
 */
-void
-StyleFactoryHelper::mergeDefaultStyleStateOperation(const QSharedPointer<StyleStateOperation> &operation,
-                                                    const StyleState *state)
+void StyleFactoryHelper::mergeDefaultStyleStateOperation(StyleStateOperation *operation,
+                                                         const StyleState *state)
 {
     Q_ASSERT_X(operation, "mergeDefaultStyleStateOperation", "operation is null");
     Q_ASSERT_X(state, "mergeDefaultStyleStateOperation", "state is null");
 
     auto *const d_state = StyleStatePrivate::get(state);
+    auto *const controller = stateController();
 
     for (auto i = 0; i < d_state->changes.count(); ++i)
     {
         const auto *const changes = d_state->changes.at(i);
-        operation->insertExpressionMapping(i, qMakePair(m_control, changes->target()));
+        controller->insertExpressionMapping(operation, i, qMakePair(m_control, changes->target()));
     }
 }
 
 /*!
-    Pushes a new error to the errors' queue.
+    Returns the state controller of the style \e owner, or a null pointer if the style \e owner is
+    null and the error policy doesn't throw.
+
+    \throw NullPointerException if the style \e owner is null.
+*/
+StyleStateController *StyleFactoryHelper::stateController() const
+{
+    if (!ExceptionHandler::checkNullPointer(m_styleOwner, QStringLiteral("style owner")))
+        return nullptr;
+
+    return StylePrivate::get(m_styleOwner)->stateController();
+}
+
+/*!
+    Pushes a new error to the errors' queue. The error is described by its \a code and, for the
+    errors related to a style's state, by the names of the \a operation and the \a state.
+
+    No message is composed here, see mappingErrors().
 
     \sa mapping(), hasErrors(), clearMappingErrors()
 */
-void StyleFactoryHelper::pushMappingError(QString &&error) noexcept
+void StyleFactoryHelper::pushMappingError(MappingError::Code code, const QString &operation,
+                                          const QString &state) noexcept
 {
-    m_errors.push(std::move(error));
+    m_errors.push(MappingError{code, operation, state});
 
     if (!m_hasErrors)
     {
@@ -476,11 +573,44 @@ void StyleFactoryHelper::pushMappingError(QString &&error) noexcept
 */
 void StyleFactoryHelper::clearMappingErrors() noexcept
 {
-    std::queue<QString> errors{};
+    std::queue<MappingError> errors{};
     m_errors.swap(errors);
     m_hasErrors = false;
 }
 
+/*!
+    Returns the translated message of the mapping \a error.
+*/
+QString StyleFactoryHelper::formatMappingError(const MappingError &error)
+{
+    switch (error.code)
+    {
+    case MappingError::Code::SameStyles:
+        return QObject::tr("style owner and style target are same.");
+    case MappingError::Code::StatesCount:
+        return QObject::tr("the style's states number from the style owner are not equal to the "
+                           "style's states number of the style target.");
+    case MappingError::Code::OperationName:
+        return QObject::tr("the style state operation '%1' is not the same as the given style's "
+                           "state '%2'.")
+                .arg(error.operation)
+                .arg(error.state);
+    case MappingError::Code::ExpressionsCount:
+        return QObject::tr("the style state operation '%1' from the owner style are not equal to "
+                           "the style property changes of the style's state '%2' of the target "
+                           "style.")
+                .arg(error.operation)
+                .arg(error.state);
+    case MappingError::Code::MergeState:
+        return QObject::tr("impossible to merge the style's state '%2' from the style target to "
+                           "the style state operation '%1' from the style owner.")
+                .arg(error.operation)
+                .arg(error.state);
+    }
+
+    return {};
+}
+
 //--------------------------------------------------------------------------------------------------
 } // namespace StoiridhControlsTemplates
 //--------------------------------------------------------------------------------------------------
@@ -39,7 +39,6 @@
 #include "api/internal/style/stylestateoperation.hpp"
 
 #include <QtCore/QPointer>
-#include <QtCore/QSharedPointer>
 
 #include <queue>
 
@@ -52,6 +51,7 @@ class Control;
 class Style;
 class StylePropertyChanges;
 class StyleState;
+class StyleStateController;
 
 class SCT_INTERNAL_API StyleFactoryHelper final
 {
@@ -64,17 +64,16 @@ public:
     Style *style() const;
     void setStyleDispatcher(const AbstractStyleDispatcher *dispatcher);
 
-    const QString &controlId() const;
+    QString controlId() const;
 
     void createStyleStatesOperations();
+    bool createNextStyleStateOperation();
 
-    QSharedPointer<StyleStateOperation>
-    createStyleStateOperation(const StyleState *state);
+    StyleStateOperation *createStyleStateOperation(const StyleState *state);
 
-    bool mergeStyleStateOperation(const QSharedPointer<StyleStateOperation> &operation,
-                                  const StyleState *state);
+    bool mergeStyleStateOperation(StyleStateOperation *operation, const StyleState *state);
 
-    QSharedPointer<StylePropertyExpression>
+    StylePropertyExpression
     createStylePropertyExpression(StylePropertyChanges *changes, bool useDefaultProperties = false);
 
     bool mapping();
@@ -86,18 +85,38 @@ public:
     StyleFactoryHelper &operator=(StyleFactoryHelper &&rhs) = delete;
 
 private:
-    QSharedPointer<StyleStateOperation> createDefaultStyleStateOperation();
-    void mergeDefaultStyleStateOperation(const QSharedPointer<StyleStateOperation> &operation,
-                                         const StyleState *state);
-
-    void pushMappingError(QString &&error) noexcept;
+    struct MappingError
+    {
+        enum class Code
+        {
+            SameStyles,
+            StatesCount,
+            OperationName,
+            ExpressionsCount,
+            MergeState
+        };
+
+        Code code;
+        QString operation;
+        QString state;
+    };
+
+    StyleStateOperation *createDefaultStyleStateOperation();
+    void mergeDefaultStyleStateOperation(StyleStateOperation *operation, const StyleState *state);
+
+    StyleStateController *stateController() const;
+
+    void pushMappingError(MappingError::Code code, const QString &operation = {},
+                          const QString &state = {}) noexcept;
     void clearMappingErrors() noexcept;
+    static QString formatMappingError(const MappingError &error);
 
 private:
     QPointer<const Control> m_control{};
     QPointer<Style> m_styleOwner{};
     QPointer<Style> m_styleTarget{};
-    mutable std::queue<QString> m_errors{};
+    mutable std::queue<MappingError> m_errors{};
+    int m_nextStyleState{-1};
     bool m_hasErrors{false};
 };
 
@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "stylefactorytask.hpp"
+
+#include "control.hpp"
+#include "core/exception/exceptionhandler.hpp"
+
+#include "api/internal/style/abstractstyledispatcher.hpp"
+
+#include <algorithm>
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+
+/*! \class StyleFactoryTask
+    \since StoiridhControlsTemplates 1.0
+    \ingroup style
+
+    \brief The StyleFactoryTask class creates incrementally the style of a control's signature.
+
+    A style factory task is used by the StyleFactory when a control is created asynchronously, e.g.,
+    from an incubator. Instead of creating all the style state operations at once, the task creates
+    one style state operation per step() so that the work can be spread over several frames.
+
+    The first request of the task is the \e owner, its style is used to create the style state
+    operations. The other requests, made by the controls of the same signature while the task is in
+    progress, will be mapped to the style of the \e owner once the task is finished.
+
+    If the \e owner is destroyed before the task is finished, the task restarts with the next
+    request.
+
+    \sa StyleFactory, StyleFactoryHelper
+*/
+
+
+/*!
+    Constructs a style factory task with the given dispatcher \a factory.
+*/
+StyleFactoryTask::StyleFactoryTask(DispatcherFactory &&factory)
+    : m_factory{std::move(factory)}
+{
+
+}
+
+/*!
+    Returns true if the task has not requests from living controls, otherwise, false.
+*/
+bool StyleFactoryTask::isEmpty() const noexcept
+{
+    return std::none_of(std::begin(m_requests), std::end(m_requests), [](const Request &request) {
+        return !request.control.isNull();
+    });
+}
+
+/*!
+    Adds a request for the \a control. The \a callback will be invoked with the style of the
+    \a control once the task is finished.
+
+    \throw NullPointerException if \a control is null.
+*/
+void StyleFactoryTask::addRequest(Control *control, Callback &&callback)
+{
+    if (!ExceptionHandler::checkNullPointer(control,
+                                            QStringLiteral("control"),
+                                            QStringLiteral("Control *")))
+        return;
+
+    m_requests.append(Request{control, std::move(callback)});
+}
+
+/*!
+    Takes the requests of the task. The first request is the \e owner of the task.
+*/
+QVector<StyleFactoryTask::Request> StyleFactoryTask::takeRequests() noexcept
+{
+    removeDestroyedRequests();
+
+    QVector<Request> requests{};
+    requests.swap(m_requests);
+    return requests;
+}
+
+/*!
+    Creates the next style state operation.
+
+    \return true if steps remain, otherwise, false. When the task has not requests anymore, false is
+            returned as well.
+*/
+bool StyleFactoryTask::step()
+{
+    if (!m_owner)
+    {
+        // the owner has been destroyed, thus, restart the creation with the next request.
+        removeDestroyedRequests();
+
+        if (m_requests.isEmpty())
+        {
+            m_helper.reset();
+            return false;
+        }
+
+        m_owner = m_requests.first().control;
+        m_helper.reset(new StyleFactoryHelper{m_owner});
+    }
+
+    return m_helper->createNextStyleStateOperation();
+}
+
+/*!
+    Creates the style dispatcher of the style of the \e owner.
+
+    \pre step() must have returned false and the task must not be empty.
+*/
+AbstractStyleDispatcher *StyleFactoryTask::createStyleDispatcher()
+{
+    Q_ASSERT_X(m_owner && m_helper, "createStyleDispatcher", "the task is empty");
+    return m_factory(m_helper->style());
+}
+
+/*!
+    \internal
+
+    Removes the requests of the destroyed controls.
+*/
+void StyleFactoryTask::removeDestroyedRequests() noexcept
+{
+    auto predicate = [](const Request &request) { return request.control.isNull(); };
+
+    m_requests.erase(std::remove_if(std::begin(m_requests), std::end(m_requests), predicate),
+                     std::end(m_requests));
+}
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef STOIRIDHCONTROLSTEMPLATES_INTERNAL_STYLE_UTILITY_STYLEFACTORYTASK_HPP
+#define STOIRIDHCONTROLSTEMPLATES_INTERNAL_STYLE_UTILITY_STYLEFACTORYTASK_HPP
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  --------------------------------------------------------------------------------------------  //
+//  /!\                                     W A R N I N G                                    /!\  //
+//  --------------------------------------------------------------------------------------------  //
+//                                                                                                //
+//  This internal header file is not part of StoiridhControlsTemplates API. It exists purely as   //
+//  an internal use and must not be used in external project(s).                                  //
+//                                                                                                //
+//  The content of this file may change from version to version without notice, or even be        //
+//  removed.                                                                                      //
+//                                                                                                //
+//  You are forewarned!                                                                           //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "api/internal/global.hpp"
+#include "api/internal/style/utility/stylefactoryhelper.hpp"
+
+#include <QtCore/QPointer>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QVector>
+
+#include <functional>
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+class AbstractStyleDispatcher;
+class Control;
+class Style;
+
+class SCT_INTERNAL_API StyleFactoryTask final
+{
+public:
+    using Callback = std::function<void(Style *)>;
+    using DispatcherFactory = std::function<AbstractStyleDispatcher *(Style *)>;
+
+    struct Request
+    {
+        QPointer<Control> control{};
+        Callback callback{};
+    };
+
+public:
+    explicit StyleFactoryTask(DispatcherFactory &&factory);
+    StyleFactoryTask(const StyleFactoryTask &rhs) = delete;
+    StyleFactoryTask(StyleFactoryTask &&rhs) = delete;
+    ~StyleFactoryTask() = default;
+
+    bool isEmpty() const noexcept;
+
+    void addRequest(Control *control, Callback &&callback);
+    QVector<Request> takeRequests() noexcept;
+
+    bool step();
+    AbstractStyleDispatcher *createStyleDispatcher();
+
+    StyleFactoryTask &operator=(const StyleFactoryTask &rhs) = delete;
+    StyleFactoryTask &operator=(StyleFactoryTask &&rhs) = delete;
+
+private:
+    void removeDestroyedRequests() noexcept;
+
+private:
+    DispatcherFactory m_factory{};
+    QScopedPointer<StyleFactoryHelper> m_helper{};
+    QPointer<Control> m_owner{};
+    QVector<Request> m_requests{};
+};
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
+
+#endif // STOIRIDHCONTROLSTEMPLATES_INTERNAL_STYLE_UTILITY_STYLEFACTORYTASK_HPP
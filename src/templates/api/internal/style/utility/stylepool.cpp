@@ -0,0 +1,166 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "stylepool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+
+/*! \class StylePool
+    \since StoiridhControlsTemplates 1.0
+    \ingroup style
+
+    \brief The StylePool class owns the style state operations and the style property expressions
+           of a compiled style.
+
+    Instead of allocating each object in its own heap block, the StylePool class places the
+    objects it creates contiguously in a few large memory blocks, called \e slabs. Consequently,
+    the objects of a style are visited with a better locality when a StyleStateOperation is
+    applied to a control and releasing a style only costs one deallocation per slab.
+
+    The objects are destroyed, in the reverse order of their creation, when the pool is destroyed.
+    There is no way to destroy a single object before, which matches the life-cycle of a compiled
+    style where the operations and the expressions live as long as their StyleStateController.
+
+    \code
+    auto pool = QSharedPointer<StylePool>::create();
+
+    auto operation = StylePool::createShared<StyleStateOperation>(pool, QStringLiteral("hovered"));
+    auto expression = StylePool::createShared<StylePropertyExpression>(pool);
+    \endcode
+
+    \note StylePool is not thread-safe. A pool must only be used from the thread of its style.
+
+    \sa StyleStateController
+*/
+
+
+constexpr std::size_t StylePool::DefaultSlabSize;
+
+/*!
+    Constructs a style pool whose slabs have, at least, \a slabSize bytes.
+*/
+StylePool::StylePool(std::size_t slabSize)
+    : m_slabSize{std::max<std::size_t>(slabSize, alignof(std::max_align_t))}
+{
+}
+
+/*!
+    Destroys this style pool and all the objects created by it.
+*/
+StylePool::~StylePool()
+{
+    for (auto it = m_objects.rbegin(); it != m_objects.rend(); ++it)
+    {
+        it->destroy(it->address);
+    }
+}
+
+/*!
+    Returns the number of bytes reserved by the slabs of the style pool.
+*/
+qint64 StylePool::capacity() const noexcept
+{
+    qint64 result{};
+
+    for (const auto &slab : m_slabs)
+    {
+        result += static_cast<qint64>(slab.size);
+    }
+
+    return result;
+}
+
+/*!
+    Returns an uninitialised memory block of \a size bytes aligned on \a alignment bytes.
+
+    A new slab is reserved when the current slab can't hold the memory block.
+*/
+void *StylePool::allocate(std::size_t size, std::size_t alignment)
+{
+    Q_ASSERT_X(alignment <= alignof(std::max_align_t), "StylePool::allocate",
+               "over-aligned types are not supported");
+
+    if (!m_slabs.empty())
+    {
+        auto &slab = m_slabs.back();
+        const auto offset = (slab.used + alignment - 1) & ~(alignment - 1);
+
+        if (offset + size <= slab.size)
+        {
+            slab.used = offset + size;
+            return slab.data.get() + offset;
+        }
+    }
+
+    // the memory returned by new[] is suitably aligned for any fundamental type, so an object
+    // placed at the beginning of a slab is always aligned.
+    const auto slabSize = std::max(m_slabSize, size);
+    m_slabs.push_back(Slab{std::unique_ptr<char[]>{new char[slabSize]}, slabSize, size});
+
+    return m_slabs.back().data.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////   DOCUMENTATION    ////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \variable StylePool::DefaultSlabSize
+
+    The default size, in bytes, of a slab.
+*/
+
+/*! \fn bool StylePool::isEmpty() const noexcept
+
+    Returns true if the style pool has not created any object, otherwise, false.
+*/
+
+/*! \fn int StylePool::count() const noexcept
+
+    Returns the number of objects created by the style pool.
+*/
+
+/*! \fn int StylePool::slabCount() const noexcept
+
+    Returns the number of slabs reserved by the style pool.
+*/
+
+/*! \fn template<typename T, typename... Args> T *StylePool::create(Args &&...args)
+
+    Creates an object of type \c T from \a args in the style pool and returns a pointer on it.
+
+    The object is owned by the style pool and must not be deleted.
+*/
+
+/*! \fn template<typename T, typename... Args> QSharedPointer<T> StylePool::createShared(const QSharedPointer<StylePool> &pool, Args &&...args)
+
+    Creates an object of type \c T from \a args in the style \a pool and returns a shared pointer
+    on it.
+
+    The shared pointer keeps a reference on the \a pool, so the object remains valid as long as a
+    shared pointer refers to it, even if the owner of the \a pool has been destroyed.
+*/
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef STOIRIDHCONTROLSTEMPLATES_INTERNAL_STYLE_UTILITY_STYLEPOOL_HPP
+#define STOIRIDHCONTROLSTEMPLATES_INTERNAL_STYLE_UTILITY_STYLEPOOL_HPP
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  --------------------------------------------------------------------------------------------  //
+//  /!\                                     W A R N I N G                                    /!\  //
+//  --------------------------------------------------------------------------------------------  //
+//                                                                                                //
+//  This internal header file is not part of StoiridhControlsTemplates API. It exists purely as   //
+//  an internal use and must not be used in external project(s).                                  //
+//                                                                                                //
+//  The content of this file may change from version to version without notice, or even be        //
+//  removed.                                                                                      //
+//                                                                                                //
+//  You are forewarned!                                                                           //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "api/internal/global.hpp"
+
+#include <QtCore/QSharedPointer>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+class SCT_INTERNAL_API StylePool final
+{
+public:
+    static constexpr std::size_t DefaultSlabSize{4096};
+
+public:
+    explicit StylePool(std::size_t slabSize = DefaultSlabSize);
+    StylePool(const StylePool &rhs) = delete;
+    StylePool(StylePool &&rhs) = delete;
+    ~StylePool();
+
+    bool isEmpty() const noexcept;
+    int count() const noexcept;
+    int slabCount() const noexcept;
+    qint64 capacity() const noexcept;
+
+    template<typename T, typename... Args>
+    T *create(Args &&...args);
+
+    template<typename T, typename... Args>
+    static QSharedPointer<T> createShared(const QSharedPointer<StylePool> &pool, Args &&...args);
+
+    StylePool &operator=(const StylePool &rhs) = delete;
+    StylePool &operator=(StylePool &&rhs) = delete;
+
+private:
+    struct Slab
+    {
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+        std::size_t used;
+    };
+
+    struct Object
+    {
+        void *address;
+        void (*destroy)(void *);
+    };
+
+    void *allocate(std::size_t size, std::size_t alignment);
+
+    template<typename T>
+    static void destroy(void *address) noexcept;
+
+private:
+    std::size_t m_slabSize{DefaultSlabSize};
+    std::vector<Slab> m_slabs{};
+    std::vector<Object> m_objects{};
+};
+
+//--------------------------------------------------------------------------------------------------
+
+inline bool StylePool::isEmpty() const noexcept
+{
+    return m_objects.empty();
+}
+
+inline int StylePool::count() const noexcept
+{
+    return static_cast<int>(m_objects.size());
+}
+
+inline int StylePool::slabCount() const noexcept
+{
+    return static_cast<int>(m_slabs.size());
+}
+
+template<typename T, typename... Args>
+T *StylePool::create(Args &&...args)
+{
+    auto *const address = allocate(sizeof(T), alignof(T));
+
+    // register the object before constructing it so that a failed registration can't leave a
+    // constructed object that the pool won't destroy.
+    m_objects.push_back(Object{address, &StylePool::destroy<T>});
+
+    QT_TRY
+    {
+        return new (address) T(std::forward<Args>(args)...);
+    }
+    QT_CATCH (...)
+    {
+        m_objects.pop_back();
+        QT_RETHROW;
+    }
+}
+
+template<typename T, typename... Args>
+QSharedPointer<T> StylePool::createShared(const QSharedPointer<StylePool> &pool, Args &&...args)
+{
+    Q_ASSERT_X(pool, "StylePool::createShared", "pool is null");
+
+    // the deleter does not destroy the object, it only holds a reference on the pool so that the
+    // pool outlives every shared pointer of its objects.
+    return QSharedPointer<T>{pool->create<T>(std::forward<Args>(args)...), [pool](T *) {}};
+}
+
+template<typename T>
+void StylePool::destroy(void *address) noexcept
+{
+    static_cast<T *>(address)->~T();
+}
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
+
+#endif // STOIRIDHCONTROLSTEMPLATES_INTERNAL_STYLE_UTILITY_STYLEPOOL_HPP
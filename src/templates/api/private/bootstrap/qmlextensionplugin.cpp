@@ -18,12 +18,15 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #include "qmlextensionplugin_p.hpp"
 
+#include "api/internal/diagnostics/stylestatistics.hpp"
 #include "api/internal/style/style.hpp"
 #include "api/internal/style/stylefactory.hpp"
 #include "api/internal/style/stylepropertychanges.hpp"
 #include "api/internal/style/stylepropertychangesparser.hpp"
 #include "api/internal/style/stylestate.hpp"
+#include "api/internal/style/stylewarmup.hpp"
 
+#include <QtCore/QCoreApplication>
 #include <QtQml/QQmlEngine>
 #include <QtQml/qqml.h>
 
@@ -44,15 +47,29 @@ namespace StoiridhControlsTemplates { namespace Bootstrap {
 
 
 /*!
-    Initialises the QML extension plugin.
+    Initialises the QML extension plugin for the QML \a engine.
+
+    The styles created for the QML \a engine are destroyed when the application is about to quit,
+    or with the QML \a engine if it is destroyed beforehand.
 */
 void QmlExtensionPlugin::init(const QQmlEngine *engine)
 {
-    // destroys all style dispatchers from the style factory only when the QML engine is destroyed.
-    QQmlEngine::connect(engine, &QQmlEngine::destroyed, []()
+    // destroys the style dispatchers of the QML engine from the style factory when the QML engine
+    // is destroyed.
+    QQmlEngine::connect(engine, &QQmlEngine::destroyed, [engine]()
     {
-        StyleFactory::destroy();
+        StyleFactory::destroy(engine);
     });
+
+    // or, beforehand, when the application is about to quit, so that the controls destroyed with
+    // the root objects of the QML engine have no mappings to remove.
+    if (auto *const application = QCoreApplication::instance())
+    {
+        QCoreApplication::connect(application, &QCoreApplication::aboutToQuit, engine, [engine]()
+        {
+            StyleFactory::destroy(engine);
+        });
+    }
 }
 
 /*!
@@ -67,6 +84,11 @@ void QmlExtensionPlugin::qmlRegisterInternalTypes(const char *uri)
     qmlRegisterType<SCT::StyleState>(uri, 1, 0, "StyleState");
     qmlRegisterCustomType<SCT::StylePropertyChanges>(uri, 1, 0, "StylePropertyChanges",
                                                      new SCT::StylePropertyChangesParser{});
+    qmlRegisterType<SCT::StyleWarmUp>(uri, 1, 0, "StyleWarmUp");
+
+    // diagnostics
+    qmlRegisterSingletonType<SCT::StyleStatistics>(uri, 1, 0, "StyleStatistics",
+                                                   &SCT::StyleStatistics::qmlSingleton);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -38,7 +38,10 @@
 #include "padding.hpp"
 
 #include "api/internal/abstractcontrol.hpp"
+#include "api/internal/diagnostics/styletracerecorder.hpp"
 
+#include <QtCore/QHash>
+#include <QtCore/QMetaEnum>
 #include <QtCore/QPointer>
 
 #include <QtQuick/private/qquickitem_p.h>
@@ -55,7 +58,7 @@ namespace StoiridhControlsTemplates {
 
 class Style;
 
-class ControlPrivate : public QQuickItemPrivate, public AbstractControl
+class SCT_INTERNAL_API ControlPrivate : public QQuickItemPrivate, public AbstractControl
 {
     Q_DECLARE_PUBLIC(Control)
 
@@ -67,16 +70,20 @@ public:
     static const ControlPrivate *get(const Control *control);
 
     void init(QQuickItem *parent);
+    bool isIncubatingAsynchronously() const;
     void accept(AbstractStyleDispatcher *dispatcher) override final;
 
     StoiridhControlsTemplates::Style *style() const;
     void setStyle(StoiridhControlsTemplates::Style *style);
     void updateStyle();
+    void updatePendingStyle();
+    void applyStyle();
 
-    QString styleState() const;
+    const QString &styleState() const;
 
     template<typename T>
     void updateStyleState(T currentState);
+    static QHash<int, QString> styleStateNames(const QMetaEnum &metaEnum);
 
     virtual void initialiseDefaultStyleState();
 
@@ -92,6 +99,8 @@ public:
 private:
     QPointer<Style> m_style{};
     QString m_styleState{};
+    bool m_hasPendingStyle{false};
+    bool m_isStyleScheduled{false};
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -113,8 +122,16 @@ void ControlPrivate::updateStyleState(T currentState)
 {
     static_assert(std::is_enum<T>::value, "T is not an enumeration type.");
 
-    auto metaEnum = QMetaEnum::fromType<T>();
-    m_styleState = QString::fromUtf8(metaEnum.key(static_cast<int>(currentState)));
+    // the names are converted once per enumeration, so a switch of style's state does not allocate.
+    static const auto names = styleStateNames(QMetaEnum::fromType<T>());
+
+    const auto metaEnum = QMetaEnum::fromType<T>();
+    const char *const key = metaEnum.valueToKey(static_cast<int>(currentState));
+
+    // the key is owned by the meta-object, so it outlives the recorded event.
+    StyleTraceRecorder::instant(key, StyleTraceRecorder::Category::State, q_func());
+
+    m_styleState = names.value(static_cast<int>(currentState));
     updateStyle();
 }
 
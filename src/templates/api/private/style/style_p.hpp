@@ -39,7 +39,7 @@
 
 #include <QtCore/QList>
 #include <QtCore/QPointer>
-#include <QtCore/QSharedPointer>
+#include <QtCore/QScopedPointer>
 #include <QtQml/qqml.h>
 
 #include <QtCore/private/qobject_p.h>
@@ -68,7 +68,7 @@ public:
     AbstractStyleDispatcher *styleDispatcher() const;
     void setStyleDispatcher(AbstractStyleDispatcher *dispatcher);
 
-    QWeakPointer<StyleStateController> stateController() const;
+    StyleStateController *stateController() const;
 
     // members
     QList<StyleState *> states{};
@@ -82,7 +82,7 @@ private:
 
 private:
     QPointer<AbstractStyleDispatcher> m_dispatcher{};
-    QSharedPointer<StyleStateController> m_stateController{};
+    QScopedPointer<StyleStateController> m_stateController{};
 };
 
 //--------------------------------------------------------------------------------------------------
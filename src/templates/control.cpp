@@ -21,12 +21,19 @@
 #include "api/internal/style/style.hpp"
 #include "api/internal/style/styledispatcher.hpp"
 #include "api/internal/style/stylefactory.hpp"
+#include "api/internal/style/stylescheduler.hpp"
+#include "api/internal/style/stylestatecontroller.hpp"
 
 #include "api/private/control_p.hpp"
 #include "api/private/style/style_p.hpp"
 
+#include <QtQml/QQmlEngine>
 #include <QtQuick/QQuickItem>
 
+#include <QtQml/private/qqmlcontext_p.h>
+#include <QtQml/private/qqmldata_p.h>
+#include <QtQml/private/qqmlincubator_p.h>
+
 //--------------------------------------------------------------------------------------------------
 namespace StoiridhControlsTemplates {
 //--------------------------------------------------------------------------------------------------
@@ -61,7 +68,18 @@ Control::Control(ControlPrivate &dd, QQuickItem *parent)
 */
 Control::~Control()
 {
+    Q_D(Control);
 
+    // a shared style must not keep the mappings of a destroyed control. The style is null once it
+    // has been destroyed with its style dispatcher, e.g., when the application quits, see
+    // StyleFactory::destroy().
+    if (auto *const s = d->style())
+    {
+        if (auto *const controller = StylePrivate::get(s)->stateController())
+        {
+            controller->removeMapping(this);
+        }
+    }
 }
 
 /*! \property StoiridhControlsTemplates::Control::availableWidth
@@ -199,6 +217,8 @@ void Control::setContent(QQuickItem *content)
 void Control::componentComplete()
 {
     Q_D(Control);
+    StyleTraceScope scope{"Control::componentComplete", StyleTraceRecorder::Category::Control,
+                          this};
 
     QQuickItem::componentComplete();
 
@@ -211,9 +231,22 @@ void Control::componentComplete()
     {
         // the StyleFactory can only operate on the style created from the QML engine when the
         // control has completed construction.
-        auto *const style = StyleFactory::create<StyleDispatcher>(this);
-        d->setStyle(style);
-        d->initialiseDefaultStyleState();
+        if (d->isIncubatingAsynchronously())
+        {
+            // spread the creation of the style over several frames in order to keep the user
+            // interface responsive during an asynchronous creation.
+            StyleFactory::createIncrementally<StyleDispatcher>(this, [this](Style *style) {
+                Q_D(Control);
+                d->setStyle(style);
+                d->initialiseDefaultStyleState();
+            });
+        }
+        else
+        {
+            auto *const style = StyleFactory::create<StyleDispatcher>(this);
+            d->setStyle(style);
+            d->initialiseDefaultStyleState();
+        }
     }
 }
 
@@ -227,6 +260,18 @@ void Control::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeomet
     d->calculateContentGeometry();
 }
 
+/*! \reimp */
+void Control::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    QQuickItem::itemChange(change, value);
+
+    if (change == ItemVisibleHasChanged && value.boolValue)
+    {
+        Q_D(Control);
+        d->updatePendingStyle();
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////   PRIVATE API    /////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -240,6 +285,24 @@ void ControlPrivate::init(QQuickItem *parent)
     padding = new Padding{parent};
 }
 
+bool ControlPrivate::isIncubatingAsynchronously() const
+{
+    Q_Q(const Control);
+
+    auto *const data = QQmlData::get(q);
+
+    // as QQmlIncubator::AsynchronousIfNested does, the first context under construction tells
+    // whether the control is created by an asynchronous incubator. The incubation of other objects
+    // by the QML engine does not matter.
+    for (auto *context = data ? data->context : nullptr; context; context = context->parent)
+    {
+        if (context->incubator)
+            return context->incubator->isAsynchronous;
+    }
+
+    return false;
+}
+
 void ControlPrivate::accept(AbstractStyleDispatcher *dispatcher)
 {
     Q_Q(Control);
@@ -275,16 +338,77 @@ void ControlPrivate::updateStyle()
 {
     if (auto *const s = style())
     {
-        auto *const d_style = StylePrivate::get(s);
-        accept(d_style->styleDispatcher());
+        // defer the style of a hidden control until it becomes effectively visible, only its last
+        // style's state will be applied.
+        if (!effectiveVisible)
+        {
+            m_hasPendingStyle = true;
+            return;
+        }
+
+        m_hasPendingStyle = false;
+
+        // the style scheduler applies the latest style's state, so a control is scheduled once.
+        if (!m_isStyleScheduled)
+        {
+            Q_Q(Control);
+            m_isStyleScheduled = true;
+            StyleScheduler::instance()->schedule(q, [this]() { applyStyle(); });
+        }
     }
 }
 
-QString ControlPrivate::styleState() const
+void ControlPrivate::updatePendingStyle()
+{
+    if (m_hasPendingStyle)
+        updateStyle();
+}
+
+void ControlPrivate::applyStyle()
+{
+    m_isStyleScheduled = false;
+
+    auto *const s = style();
+
+    if (!s)
+        return;
+
+    // the control may have been hidden while its style was scheduled.
+    if (!effectiveVisible)
+    {
+        m_hasPendingStyle = true;
+        return;
+    }
+
+    auto *const d_style = StylePrivate::get(s);
+
+    // the style has not been created by the StyleFactory yet.
+    if (!d_style->styleDispatcher())
+        return;
+
+    accept(d_style->styleDispatcher());
+}
+
+const QString &ControlPrivate::styleState() const
 {
     return m_styleState;
 }
 
+QHash<int, QString> ControlPrivate::styleStateNames(const QMetaEnum &metaEnum)
+{
+    QHash<int, QString> names{};
+    names.reserve(metaEnum.keyCount());
+
+    // the names are indexed by value since the values of an enumeration are not necessarily its
+    // indices, e.g., enum State { Normal = 1, Hovered = 4 }.
+    for (int i = 0; i < metaEnum.keyCount(); ++i)
+    {
+        names.insert(metaEnum.value(i), QString::fromUtf8(metaEnum.key(i)));
+    }
+
+    return names;
+}
+
 void ControlPrivate::initialiseDefaultStyleState()
 {
     // a control is an abstract concept so it has not a default style's state.
@@ -293,6 +417,7 @@ void ControlPrivate::initialiseDefaultStyleState()
 void ControlPrivate::calculateBackgroundGeometry()
 {
     Q_Q(Control);
+    StyleTraceScope scope{"calculateBackgroundGeometry", StyleTraceRecorder::Category::Geometry, q};
 
     if (!background)
         return;
@@ -326,6 +451,7 @@ void ControlPrivate::calculateBackgroundGeometry()
 void ControlPrivate::calculateContentGeometry()
 {
     Q_Q(Control);
+    StyleTraceScope scope{"calculateContentGeometry", StyleTraceRecorder::Category::Geometry, q};
 
     if (!content)
         return;
@@ -77,6 +77,7 @@ protected:
 
     void componentComplete() override;
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+    void itemChange(ItemChange change, const ItemChangeData &value) override;
 
 private:
     Q_DISABLE_COPY(Control)
@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef STOIRIDHCONTROLSTEMPLATES_CORE_EXCEPTION_ERRORPOLICY_HPP
+#define STOIRIDHCONTROLSTEMPLATES_CORE_EXCEPTION_ERRORPOLICY_HPP
+
+#include <StoiridhControlsTemplates/global.hpp>
+
+//--------------------------------------------------------------------------------------------------
+namespace StoiridhControlsTemplates {
+//--------------------------------------------------------------------------------------------------
+
+enum class ErrorPolicy
+{
+    Throw,
+    Assert,
+    ErrorCode
+};
+
+#if defined(SCT_ERROR_POLICY_ERROR_CODE)
+constexpr ErrorPolicy DefaultErrorPolicy{ErrorPolicy::ErrorCode};
+#elif defined(SCT_ERROR_POLICY_ASSERT)
+constexpr ErrorPolicy DefaultErrorPolicy{ErrorPolicy::Assert};
+#elif defined(QT_NO_EXCEPTIONS)
+constexpr ErrorPolicy DefaultErrorPolicy{ErrorPolicy::ErrorCode};
+#else
+constexpr ErrorPolicy DefaultErrorPolicy{ErrorPolicy::Throw};
+#endif
+
+//--------------------------------------------------------------------------------------------------
+} // namespace StoiridhControlsTemplates
+//--------------------------------------------------------------------------------------------------
+
+#endif // STOIRIDHCONTROLSTEMPLATES_CORE_EXCEPTION_ERRORPOLICY_HPP
@@ -18,6 +18,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #include "exception.hpp"
 
+#ifndef QT_NO_EXCEPTIONS
 //--------------------------------------------------------------------------------------------------
 namespace StoiridhControlsTemplates {
 //--------------------------------------------------------------------------------------------------
@@ -83,3 +84,4 @@ void Exception::setMessage(QString &&message)
 //--------------------------------------------------------------------------------------------------
 } // namespace StoiridhControlsTemplates
 //--------------------------------------------------------------------------------------------------
+#endif // QT_NO_EXCEPTIONS
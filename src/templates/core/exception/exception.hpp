@@ -24,6 +24,7 @@
 #include <QException>
 #include <QString>
 
+#ifndef QT_NO_EXCEPTIONS
 //--------------------------------------------------------------------------------------------------
 namespace StoiridhControlsTemplates {
 //--------------------------------------------------------------------------------------------------
@@ -50,5 +51,6 @@ private:
 //--------------------------------------------------------------------------------------------------
 } // namespace StoiridhControlsTemplates
 //--------------------------------------------------------------------------------------------------
+#endif // QT_NO_EXCEPTIONS
 
 #endif // STOIRIDHCONTROLSTEMPLATES_CORE_EXCEPTION_EXCEPTION_HPP
@@ -20,21 +20,35 @@
 #define STOIRIDHCONTROLSTEMPLATES_CORE_EXCEPTION_EXCEPTIONHANDLER_HPP
 
 #include <StoiridhControlsTemplates/global.hpp>
+#include <StoiridhControlsTemplates/Core/Exception/ErrorPolicy>
 #include <StoiridhControlsTemplates/Core/Exception/NullPointerException>
 
 #include <QObject>
 
+#ifndef QT_NO_EXCEPTIONS
+#include <stdexcept>
+#endif
+
 //--------------------------------------------------------------------------------------------------
 namespace StoiridhControlsTemplates {
 //--------------------------------------------------------------------------------------------------
 
-class STOIRIDH_CONTROLS_TEMPLATES_API ExceptionHandler
+template<ErrorPolicy Policy>
+struct ErrorPolicyTraits;
+
+template<ErrorPolicy Policy>
+class BasicExceptionHandler
 {
 public:
+    static constexpr ErrorPolicy policy{Policy};
+
     template<typename T>
-    static void checkNullPointer(T pointer, const QString &name = {}, const QString &type = {});
+    static bool checkNullPointer(T pointer, const QString &name = {}, const QString &type = {});
+    static bool checkArgument(bool condition, const QString &message);
 };
 
+using ExceptionHandler = BasicExceptionHandler<DefaultErrorPolicy>;
+
 //--------------------------------------------------------------------------------------------------
 } // namespace StoiridhControlsTemplates
 //--------------------------------------------------------------------------------------------------
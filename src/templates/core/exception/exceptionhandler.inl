@@ -22,18 +22,97 @@ namespace StoiridhControlsTemplates {
 //--------------------------------------------------------------------------------------------------
 
 
-/*! \class ExceptionHandler
+/*! \class BasicExceptionHandler
     \since StoiridhControlsTemplates 1.0
     \ingroup core
     \ingroup exception
 
-    \brief The ExceptionHandler class is a utility class to handle the exceptions.
+    \brief The BasicExceptionHandler class is a utility class to handle the errors.
 
-    The class defines a set of static methods in order to handle an exception type. Generally, each
+    The class defines a set of static methods in order to handle an error type. Generally, each
     methods come with a boolean condition and two others parameters. Those parameters are purely
-    used to compose a pretty message when the exception is thrown.
+    used to compose a pretty message when the error is reported.
+
+    How an error is reported depends on the \e Policy template parameter:
+
+    \list
+        \li ErrorPolicy::Throw throws an exception. It requires a build with exceptions.
+        \li ErrorPolicy::Assert asserts in debug builds and returns false in release builds.
+        \li ErrorPolicy::ErrorCode only returns false.
+    \endlist
+
+    Each method returns true when the condition holds, so that the callers can bail out when an
+    error is reported without an exception:
+
+    \code
+    if (!ExceptionHandler::checkNullPointer(control, QStringLiteral("control")))
+        return;
+    \endcode
+
+    The library uses ExceptionHandler, whose policy is DefaultErrorPolicy. It is selected at compile
+    time by the \c STOIRIDH_CONTROLS_ERROR_POLICY build option, which defines either
+    \c SCT_ERROR_POLICY_ASSERT or \c SCT_ERROR_POLICY_ERROR_CODE. Without any of them,
+    ErrorPolicy::Throw is used, unless the exceptions are disabled (\c QT_NO_EXCEPTIONS), in which
+    case ErrorPolicy::ErrorCode is used.
+*/
+
+/*! \typedef ExceptionHandler
+    \relates BasicExceptionHandler
+
+    This type alias is the error handler used by the library, with DefaultErrorPolicy.
+*/
+
+/*! \enum ErrorPolicy
+    \relates BasicExceptionHandler
+
+    This enum describes how the errors are reported.
+
+    \value Throw        An exception is thrown.
+    \value Assert       The program asserts in debug builds.
+    \value ErrorCode    The error is only reported by the return value.
 */
 
+template<ErrorPolicy Policy>
+constexpr ErrorPolicy BasicExceptionHandler<Policy>::policy;
+
+#ifndef QT_NO_EXCEPTIONS
+template<>
+struct ErrorPolicyTraits<ErrorPolicy::Throw>
+{
+    static void nullPointer(const QString &name, const QString &type)
+    {
+        throw NullPointerException(name, type);
+    }
+
+    static void invalidArgument(const QString &message)
+    {
+        throw std::invalid_argument{message.toStdString()};
+    }
+};
+#endif
+
+template<>
+struct ErrorPolicyTraits<ErrorPolicy::Assert>
+{
+    static void nullPointer(const QString &name, const QString &type) noexcept
+    {
+        Q_UNUSED(type);
+        Q_ASSERT_X(false, "checkNullPointer", qPrintable(name));
+    }
+
+    static void invalidArgument(const QString &message) noexcept
+    {
+        Q_UNUSED(message);
+        Q_ASSERT_X(false, "checkArgument", qPrintable(message));
+    }
+};
+
+template<>
+struct ErrorPolicyTraits<ErrorPolicy::ErrorCode>
+{
+    static void nullPointer(const QString &, const QString &) noexcept {}
+    static void invalidArgument(const QString &) noexcept {}
+};
 
 /*!
     Checks if \a pointer is null.
@@ -50,22 +129,50 @@ namespace StoiridhControlsTemplates {
     {
         using StoiridhControlsTemplates::ExceptionHandler;
 
-        ExceptionHandler::checkNullPointer(control, QStringLiteral("control"),
-                                                    QStringLiteral("const Control *"));
+        if (!ExceptionHandler::checkNullPointer(control, QStringLiteral("control"),
+                                                         QStringLiteral("const Control *")))
+            return;
 
         // control is not null.
     }
     \endcode
 
-    \throw NullPointerException if \a pointer is null.
+    \return true if \a pointer is not null, otherwise, false.
+
+    \throw NullPointerException if \a pointer is null and the policy is ErrorPolicy::Throw.
 */
+template<ErrorPolicy Policy>
 template<typename T>
-void ExceptionHandler::checkNullPointer(T pointer, const QString &name, const QString &type)
+bool BasicExceptionHandler<Policy>::checkNullPointer(T pointer, const QString &name,
+                                                     const QString &type)
 {
-    if (!pointer)
+    // the explicit conversion accepts std::nullptr_t as well as the smart pointers of Qt.
+    if (!static_cast<bool>(pointer))
     {
-        throw NullPointerException(name, type);
+        ErrorPolicyTraits<Policy>::nullPointer(name, type);
+        return false;
     }
+
+    return true;
+}
+
+/*!
+    Checks if \a condition holds for an argument. \a message describes the invalid argument.
+
+    \return true if \a condition is true, otherwise, false.
+
+    \throw std::invalid_argument if \a condition is false and the policy is ErrorPolicy::Throw.
+*/
+template<ErrorPolicy Policy>
+bool BasicExceptionHandler<Policy>::checkArgument(bool condition, const QString &message)
+{
+    if (!condition)
+    {
+        ErrorPolicyTraits<Policy>::invalidArgument(message);
+        return false;
+    }
+
+    return true;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -18,6 +18,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #include "nullpointerexception.hpp"
 
+#ifndef QT_NO_EXCEPTIONS
 //--------------------------------------------------------------------------------------------------
 namespace StoiridhControlsTemplates {
 //--------------------------------------------------------------------------------------------------
@@ -83,3 +84,4 @@ const char *NullPointerException::what() const noexcept
 //--------------------------------------------------------------------------------------------------
 } // namespace StoiridhControlsTemplates
 //--------------------------------------------------------------------------------------------------
+#endif // QT_NO_EXCEPTIONS
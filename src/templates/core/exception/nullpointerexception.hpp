@@ -21,6 +21,7 @@
 
 #include <StoiridhControlsTemplates/Core/Exception/Exception>
 
+#ifndef QT_NO_EXCEPTIONS
 //--------------------------------------------------------------------------------------------------
 namespace StoiridhControlsTemplates {
 //--------------------------------------------------------------------------------------------------
@@ -40,5 +41,6 @@ public:
 //--------------------------------------------------------------------------------------------------
 } // namespace StoiridhControlsTemplates
 //--------------------------------------------------------------------------------------------------
+#endif // QT_NO_EXCEPTIONS
 
 #endif // STOIRIDHCONTROLSTEMPLATES_CORE_EXCEPTION_NULLPOINTEREXCEPTION_HPP
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <QtTest>
+
+#include <QtCore/QScopedPointer>
+
+#include <StoiridhControlsTemplates/Control>
+
+#include <StoiridhControlsTemplates/internal/diagnostics/stylememoryusage.hpp>
+#include <StoiridhControlsTemplates/internal/style/style.hpp>
+#include <StoiridhControlsTemplates/internal/style/styledispatcher.hpp>
+
+namespace SCT = StoiridhControlsTemplates;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCase                                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class TestSCTStyleMemoryUsage : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void total();
+    void toVariantMap();
+
+    void estimateDispatcher();
+    void estimateControl();
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Tests                                                                                         //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSCTStyleMemoryUsage::total()
+{
+    SCT::StyleMemoryUsage::Footprint footprint{};
+    QCOMPARE(footprint.total(), qint64{0});
+
+    footprint.style = 100;
+    footprint.operations = 20;
+    footprint.expressions = 30;
+    footprint.mappings = 4;
+    footprint.writers = 6;
+
+    QCOMPARE(footprint.total(), qint64{160});
+}
+
+void TestSCTStyleMemoryUsage::toVariantMap()
+{
+    SCT::StyleMemoryUsage::Footprint footprint{};
+    footprint.style = 100;
+    footprint.mappings = 4;
+    footprint.writers = 6;
+    footprint.controls = 2;
+
+    const auto map = footprint.toVariantMap();
+
+    QCOMPARE(map.value(QStringLiteral("style")).toDouble(), 100.0);
+    QCOMPARE(map.value(QStringLiteral("operations")).toDouble(), 0.0);
+    QCOMPARE(map.value(QStringLiteral("mappings")).toDouble(), 4.0);
+    QCOMPARE(map.value(QStringLiteral("writers")).toDouble(), 6.0);
+    QCOMPARE(map.value(QStringLiteral("controls")).toInt(), 2);
+    QCOMPARE(map.value(QStringLiteral("total")).toDouble(), 110.0);
+}
+
+void TestSCTStyleMemoryUsage::estimateDispatcher()
+{
+    QCOMPARE(SCT::StyleMemoryUsage::estimate(static_cast<SCT::AbstractStyleDispatcher *>(nullptr))
+             .total(), qint64{0});
+
+    auto *const style = new SCT::Style{};
+    QScopedPointer<SCT::AbstractStyleDispatcher> dispatcher{new SCT::StyleDispatcher{style}};
+
+    const auto footprint = SCT::StyleMemoryUsage::estimate(dispatcher.data());
+
+    QVERIFY(footprint.style >= qint64{sizeof(SCT::Style)});
+    QCOMPARE(footprint.expressions, qint64{0});
+    QCOMPARE(footprint.mappings, qint64{0});
+    QCOMPARE(footprint.writers, qint64{0});
+    QCOMPARE(footprint.controls, 0);
+}
+
+void TestSCTStyleMemoryUsage::estimateControl()
+{
+    QCOMPARE(SCT::StyleMemoryUsage::estimate(static_cast<SCT::Control *>(nullptr)), qint64{0});
+
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+    QVERIFY(SCT::StyleMemoryUsage::estimate(control.data()) > qint64{sizeof(SCT::Control)});
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Run                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QTEST_APPLESS_MAIN(TestSCTStyleMemoryUsage)
+#include "tst_sct_stylememoryusage.moc"
@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <QtTest>
+
+#include <StoiridhControlsTemplates/internal/diagnostics/stylestatistics.hpp>
+
+namespace SCT = StoiridhControlsTemplates;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCase                                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class TestSCTStyleStatistics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void constructor();
+
+    void recordDispatch();
+    void recordFailures();
+
+    void setUpdateInterval();
+    void update();
+
+    void reset();
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Tests                                                                                         //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSCTStyleStatistics::init()
+{
+    if (!SCT::StyleStatistics::isEnabled())
+        QSKIP("The library is built with SCT_NO_STYLE_STATISTICS.");
+
+    SCT::StyleStatistics statistics{};
+    statistics.reset();
+}
+
+void TestSCTStyleStatistics::constructor()
+{
+    SCT::StyleStatistics statistics{};
+
+    QCOMPARE(statistics.updateInterval(), 1000);
+    QCOMPARE(statistics.dispatcherCount(), 0);
+    QCOMPARE(statistics.expressionCount(), 0);
+    QVERIFY(statistics.mappedControls().isEmpty());
+    QVERIFY(statistics.statesPerStyle().isEmpty());
+    QCOMPARE(statistics.dispatchCount(), 0.0);
+    QCOMPARE(statistics.writeCount(), 0.0);
+}
+
+void TestSCTStyleStatistics::recordDispatch()
+{
+    SCT::StyleStatistics statistics{};
+
+    SCT::StyleStatistics::recordDispatch();
+    SCT::StyleStatistics::recordWrites(4);
+    SCT::StyleStatistics::recordDispatch();
+    SCT::StyleStatistics::recordWrites(2);
+
+    QCOMPARE(statistics.dispatchCount(), 2.0);
+    QCOMPARE(statistics.writeCount(), 6.0);
+}
+
+void TestSCTStyleStatistics::recordFailures()
+{
+    SCT::StyleStatistics statistics{};
+
+    SCT::StyleStatistics::recordFailedWrite();
+    SCT::StyleStatistics::recordFailedWrite();
+    SCT::StyleStatistics::recordFailedMapping();
+
+    QCOMPARE(statistics.failedWriteCount(), 2.0);
+    QCOMPARE(statistics.failedMappingCount(), 1.0);
+}
+
+void TestSCTStyleStatistics::setUpdateInterval()
+{
+    SCT::StyleStatistics statistics{};
+
+    QSignalSpy spy{&statistics, &SCT::StyleStatistics::updateIntervalChanged};
+    QVERIFY(spy.isValid());
+
+    statistics.setUpdateInterval(250);
+    QCOMPARE(statistics.updateInterval(), 250);
+    QCOMPARE(spy.count(), 1);
+
+    statistics.setUpdateInterval(250);
+    QCOMPARE(spy.count(), 1);
+
+    // the interval is at least 1 millisecond
+    statistics.setUpdateInterval(-1);
+    QCOMPARE(statistics.updateInterval(), 1);
+    QCOMPARE(spy.count(), 2);
+}
+
+void TestSCTStyleStatistics::update()
+{
+    SCT::StyleStatistics statistics{};
+    statistics.setUpdateInterval(10);
+
+    QSignalSpy spy{&statistics, &SCT::StyleStatistics::statisticsChanged};
+    QVERIFY(spy.isValid());
+
+    // the counters are updated by the event loop
+    QTRY_VERIFY(spy.count() > 0);
+
+    statistics.update();
+    QVERIFY(spy.count() > 1);
+}
+
+void TestSCTStyleStatistics::reset()
+{
+    SCT::StyleStatistics statistics{};
+
+    SCT::StyleStatistics::recordDispatch();
+    SCT::StyleStatistics::recordWrites(3);
+    SCT::StyleStatistics::recordFailedWrite();
+    SCT::StyleStatistics::recordFailedMapping();
+
+    statistics.reset();
+
+    QCOMPARE(statistics.dispatchCount(), 0.0);
+    QCOMPARE(statistics.writeCount(), 0.0);
+    QCOMPARE(statistics.failedWriteCount(), 0.0);
+    QCOMPARE(statistics.failedMappingCount(), 0.0);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Run                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QTEST_GUILESS_MAIN(TestSCTStyleStatistics)
+#include "tst_sct_stylestatistics.moc"
@@ -0,0 +1,196 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <QtTest>
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
+
+#include <StoiridhControlsTemplates/internal/diagnostics/styletracerecorder.hpp>
+
+namespace SCT = StoiridhControlsTemplates;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCase                                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class TestSCTStyleTraceRecorder : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QJsonArray events(const QString &category);
+
+private slots:
+    void init();
+
+    void setEnabled();
+    void setCapacity();
+
+    void instant();
+    void scope();
+
+    void ringBuffer();
+
+    void dump();
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QJsonArray TestSCTStyleTraceRecorder::events(const QString &category)
+{
+    const auto document = QJsonDocument::fromJson(SCT::StyleTraceRecorder::toJson());
+    const auto traceEvents = document.object().value(QStringLiteral("traceEvents")).toArray();
+
+    QJsonArray result{};
+
+    for (const auto &event : traceEvents)
+    {
+        if (event.toObject().value(QStringLiteral("cat")).toString() == category)
+            result.append(event);
+    }
+
+    return result;
+}
+
+class RecorderThread : public QThread
+{
+public:
+    explicit RecorderThread(int count) : m_count{count} {}
+
+protected:
+    void run() override
+    {
+        for (int i = 0; i < m_count; ++i)
+        {
+            SCT::StyleTraceRecorder::instant("thread", SCT::StyleTraceRecorder::Category::Factory,
+                                             this);
+        }
+    }
+
+private:
+    int m_count{};
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Tests                                                                                         //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSCTStyleTraceRecorder::init()
+{
+    SCT::StyleTraceRecorder::setEnabled(true);
+    SCT::StyleTraceRecorder::clear();
+}
+
+void TestSCTStyleTraceRecorder::setEnabled()
+{
+    SCT::StyleTraceRecorder::setEnabled(false);
+    QVERIFY(!SCT::StyleTraceRecorder::isEnabled());
+
+    // nothing is recorded while the recorder is disabled
+    SCT::StyleTraceRecorder::instant("disabled", SCT::StyleTraceRecorder::Category::State, this);
+    QVERIFY(events(QStringLiteral("state")).isEmpty());
+
+    SCT::StyleTraceRecorder::setEnabled(true);
+    QVERIFY(SCT::StyleTraceRecorder::isEnabled());
+}
+
+void TestSCTStyleTraceRecorder::setCapacity()
+{
+    const auto capacity = SCT::StyleTraceRecorder::capacity();
+    QCOMPARE(capacity, 16384);
+
+    // the capacity is rounded up to the next power of two
+    SCT::StyleTraceRecorder::setCapacity(100);
+    QCOMPARE(SCT::StyleTraceRecorder::capacity(), 128);
+
+    SCT::StyleTraceRecorder::setCapacity(0);
+    QCOMPARE(SCT::StyleTraceRecorder::capacity(), 1);
+
+    SCT::StyleTraceRecorder::setCapacity(capacity);
+}
+
+void TestSCTStyleTraceRecorder::instant()
+{
+    SCT::StyleTraceRecorder::instant("Pressed", SCT::StyleTraceRecorder::Category::State, this);
+
+    const auto result = events(QStringLiteral("state"));
+    QCOMPARE(result.count(), 1);
+
+    const auto event = result.at(0).toObject();
+    QCOMPARE(event.value(QStringLiteral("name")).toString(), QStringLiteral("Pressed"));
+    QCOMPARE(event.value(QStringLiteral("ph")).toString(), QStringLiteral("i"));
+    QVERIFY(event.value(QStringLiteral("args")).toObject().contains(QStringLiteral("object")));
+}
+
+void TestSCTStyleTraceRecorder::scope()
+{
+    {
+        SCT::StyleTraceScope scope{"dispatch", SCT::StyleTraceRecorder::Category::Dispatch, this};
+        QTest::qSleep(2);
+    }
+
+    const auto result = events(QStringLiteral("dispatch"));
+    QCOMPARE(result.count(), 1);
+
+    const auto event = result.at(0).toObject();
+    QCOMPARE(event.value(QStringLiteral("name")).toString(), QStringLiteral("dispatch"));
+    QCOMPARE(event.value(QStringLiteral("ph")).toString(), QStringLiteral("X"));
+    QVERIFY(event.value(QStringLiteral("dur")).toDouble() >= 1000.0);
+}
+
+void TestSCTStyleTraceRecorder::ringBuffer()
+{
+    const auto capacity = SCT::StyleTraceRecorder::capacity();
+
+    // the capacity applies to the threads that have not recorded any event yet
+    SCT::StyleTraceRecorder::setCapacity(8);
+
+    RecorderThread thread{20};
+    thread.start();
+    QVERIFY(thread.wait());
+
+    SCT::StyleTraceRecorder::setCapacity(capacity);
+
+    // only the most recent events are kept
+    QCOMPARE(events(QStringLiteral("factory")).count(), 8);
+}
+
+void TestSCTStyleTraceRecorder::dump()
+{
+    QTemporaryDir directory{};
+    QVERIFY(directory.isValid());
+
+    SCT::StyleTraceRecorder::instant("Hovered", SCT::StyleTraceRecorder::Category::State, this);
+
+    const auto filePath = directory.path() + QStringLiteral("/trace.json");
+    QVERIFY(SCT::StyleTraceRecorder::dump(filePath));
+
+    QFile file{filePath};
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    QJsonParseError error{};
+    const auto document = QJsonDocument::fromJson(file.readAll(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QVERIFY(document.object().value(QStringLiteral("traceEvents")).isArray());
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Run                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QTEST_GUILESS_MAIN(TestSCTStyleTraceRecorder)
+#include "tst_sct_styletracerecorder.moc"
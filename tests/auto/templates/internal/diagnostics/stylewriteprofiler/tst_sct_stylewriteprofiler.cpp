@@ -0,0 +1,251 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <QtTest>
+
+#include <QtCore/QScopedPointer>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+#include <QtQuick/QQuickItem>
+
+#include <StoiridhControlsTemplates/Control>
+
+#include <StoiridhControlsTemplates/internal/diagnostics/stylewriteprofiler.hpp>
+#include <StoiridhControlsTemplates/internal/style/stylepropertyexpression.hpp>
+
+namespace SCT = StoiridhControlsTemplates;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class Target : public QQuickItem
+{
+    Q_OBJECT
+
+public:
+    using QQuickItem::QQuickItem;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCase                                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class TestSCTStyleWriteProfiler : public QObject
+{
+    Q_OBJECT
+
+private:
+    static SCT::StyleWriteProfiler::Entry find(const QString &property);
+
+private slots:
+    void init();
+    void cleanupTestCase();
+
+    void setEnabled();
+
+    void writes();
+    void failures();
+    void noOps();
+    void targets();
+    void dynamicTargets();
+
+    void table();
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+SCT::StyleWriteProfiler::Entry TestSCTStyleWriteProfiler::find(const QString &property)
+{
+    for (const auto &entry : SCT::StyleWriteProfiler::entries())
+    {
+        if (entry.property == property)
+            return entry;
+    }
+
+    return SCT::StyleWriteProfiler::Entry{};
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Tests                                                                                         //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSCTStyleWriteProfiler::init()
+{
+    SCT::StyleWriteProfiler::setEnabled(true);
+    SCT::StyleWriteProfiler::clear();
+}
+
+void TestSCTStyleWriteProfiler::cleanupTestCase()
+{
+    SCT::StyleWriteProfiler::setEnabled(false);
+}
+
+void TestSCTStyleWriteProfiler::setEnabled()
+{
+    SCT::StyleWriteProfiler::setEnabled(false);
+    QVERIFY(!SCT::StyleWriteProfiler::isEnabled());
+
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+    auto *const target = new QQuickItem{control.data()};
+
+    SCT::StylePropertyExpression expression{};
+    expression.addMapping(control.data(), target);
+    expression.addProperty(QStringLiteral("width"), 75.0);
+
+    // nothing is aggregated while the profiler is disabled
+    QVERIFY(expression.apply(control.data()));
+    QVERIFY(SCT::StyleWriteProfiler::entries().isEmpty());
+
+    SCT::StyleWriteProfiler::setEnabled(true);
+    QVERIFY(SCT::StyleWriteProfiler::isEnabled());
+}
+
+void TestSCTStyleWriteProfiler::writes()
+{
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+    auto *const target = new QQuickItem{control.data()};
+
+    SCT::StylePropertyExpression expression{};
+    expression.addMapping(control.data(), target);
+    expression.addProperty(QStringLiteral("width"), 75.0);
+    expression.addProperty(QStringLiteral("height"), 25.0);
+
+    QVERIFY(expression.apply(control.data()));
+    QVERIFY(expression.apply(control.data()));
+
+    const auto entries = SCT::StyleWriteProfiler::entries();
+    QCOMPARE(entries.count(), 2);
+
+    const auto width = find(QStringLiteral("width"));
+    QCOMPARE(width.writes, qint64{2});
+    QCOMPARE(width.failures, qint64{0});
+    QCOMPARE(width.target, QStringLiteral("QQuickItem"));
+    QVERIFY(!width.controlType.isEmpty());
+}
+
+void TestSCTStyleWriteProfiler::failures()
+{
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+    auto *const target = new QQuickItem{control.data()};
+
+    SCT::StylePropertyExpression expression{};
+    expression.addMapping(control.data(), target);
+    expression.addProperty(QStringLiteral("unknownProperty"), 1);
+
+    QVERIFY(!expression.apply(control.data()));
+
+    const auto entry = find(QStringLiteral("unknownProperty"));
+    QCOMPARE(entry.writes, qint64{0});
+    QCOMPARE(entry.failures, qint64{1});
+}
+
+void TestSCTStyleWriteProfiler::noOps()
+{
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+    auto *const target = new QQuickItem{control.data()};
+
+    SCT::StylePropertyExpression expression{};
+    expression.addMapping(control.data(), target);
+    expression.addProperty(QStringLiteral("width"), 75);
+
+    // the first write changes the width, the following ones are no-ops
+    QVERIFY(expression.apply(control.data()));
+    QVERIFY(expression.apply(control.data()));
+    QVERIFY(expression.apply(control.data()));
+
+    const auto entry = find(QStringLiteral("width"));
+    QCOMPARE(entry.writes, qint64{3});
+    QCOMPARE(entry.noOps, qint64{2});
+}
+
+void TestSCTStyleWriteProfiler::targets()
+{
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+    auto *const item = new QQuickItem{control.data()};
+    auto *const target = new Target{control.data()};
+
+    SCT::StylePropertyExpression itemExpression{};
+    itemExpression.addMapping(control.data(), item);
+    itemExpression.addProperty(QStringLiteral("width"), 75.0);
+
+    SCT::StylePropertyExpression targetExpression{};
+    targetExpression.addMapping(control.data(), target);
+    targetExpression.addProperty(QStringLiteral("width"), 75.0);
+
+    QVERIFY(itemExpression.apply(control.data()));
+    QVERIFY(targetExpression.apply(control.data()));
+    QVERIFY(targetExpression.apply(control.data()));
+
+    // the same property of two distinct types of target is aggregated separately
+    const auto entries = SCT::StyleWriteProfiler::entries();
+    QCOMPARE(entries.count(), 2);
+    QCOMPARE(entries.at(0).target, QStringLiteral("Target"));
+    QCOMPARE(entries.at(0).writes, qint64{2});
+    QCOMPARE(entries.at(1).target, QStringLiteral("QQuickItem"));
+    QCOMPARE(entries.at(1).writes, qint64{1});
+}
+
+void TestSCTStyleWriteProfiler::dynamicTargets()
+{
+    QQmlEngine engine{};
+    QQmlComponent component{&engine};
+    component.setData("import QtQuick 2.6\nItem { property int extra: 0 }\n",
+                      QUrl{QStringLiteral("file:///tests/target.qml")});
+
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+
+    for (int i = 0; i < 2; ++i)
+    {
+        // each target declared in QML has its own dynamic meta-object.
+        QScopedPointer<QObject> target{component.create()};
+        QVERIFY(qobject_cast<QQuickItem *>(target.data()));
+        QVERIFY(target->metaObject() != &QQuickItem::staticMetaObject);
+
+        SCT::StylePropertyExpression expression{};
+        expression.addMapping(control.data(), qobject_cast<QQuickItem *>(target.data()));
+        expression.addProperty(QStringLiteral("width"), 75.0);
+
+        QVERIFY(expression.apply(control.data()));
+    }
+
+    // the writes are aggregated by type, not by instance.
+    const auto entries = SCT::StyleWriteProfiler::entries();
+    QCOMPARE(entries.count(), 1);
+    QCOMPARE(entries.at(0).writes, qint64{2});
+}
+
+void TestSCTStyleWriteProfiler::table()
+{
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+    auto *const target = new QQuickItem{control.data()};
+
+    SCT::StylePropertyExpression expression{};
+    expression.addMapping(control.data(), target);
+    expression.addProperty(QStringLiteral("opacity"), 0.5);
+
+    QVERIFY(expression.apply(control.data()));
+
+    const auto table = SCT::StyleWriteProfiler::table();
+    const auto lines = table.split(QLatin1Char('\n'), QString::SkipEmptyParts);
+
+    QCOMPARE(lines.count(), 2);
+    QVERIFY(lines.at(0).contains(QStringLiteral("No-ops")));
+    QVERIFY(lines.at(1).contains(QStringLiteral("opacity")));
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Run                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QTEST_MAIN(TestSCTStyleWriteProfiler)
+#include "tst_sct_stylewriteprofiler.moc"
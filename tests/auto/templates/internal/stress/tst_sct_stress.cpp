@@ -0,0 +1,335 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <QtTest>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QThread>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+#include <QtQuick/QQuickItem>
+
+#include <StoiridhControlsTemplates/Control>
+
+#include <StoiridhControlsTemplates/internal/style/stylefactory.hpp>
+#include <StoiridhControlsTemplates/private/bootstrap/qmlextensionplugin_p.hpp>
+#include <StoiridhControlsTemplates/private/control_p.hpp>
+
+#include <algorithm>
+#include <random>
+
+namespace SCT = StoiridhControlsTemplates;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class StressControl : public SCT::Control
+{
+    Q_OBJECT
+
+public:
+    enum class State { Normal, Hovered, Pressed, Disabled };
+    Q_ENUM(State)
+
+    explicit StressControl(QQuickItem *parent = nullptr)
+        : SCT::Control{parent}
+    {
+    }
+
+    void setState(State state)
+    {
+        SCT::ControlPrivate::get(this)->updateStyleState(state);
+    }
+};
+
+// a second control type, so that each engine registers several styles.
+class OtherStressControl : public StressControl
+{
+    Q_OBJECT
+
+public:
+    explicit OtherStressControl(QQuickItem *parent = nullptr)
+        : StressControl{parent}
+    {
+    }
+};
+
+QByteArray generateControl(const QByteArray &type)
+{
+    return "    " + type + " {\n"
+           "        background: Rectangle {}\n"
+           "        content: Item {}\n"
+           "        style: Style {\n"
+           "            StyleState {\n"
+           "                StylePropertyChanges {\n"
+           "                    target: background; width: 10; color: \"red\"\n"
+           "                }\n"
+           "            }\n"
+           "            StyleState {\n"
+           "                name: \"Hovered\"\n"
+           "                StylePropertyChanges { target: background; opacity: 0.5 }\n"
+           "            }\n"
+           "            StyleState {\n"
+           "                name: \"Pressed\"\n"
+           "                StylePropertyChanges { target: content; width: 20 }\n"
+           "            }\n"
+           "        }\n"
+           "    }\n";
+}
+
+QByteArray generateDocument()
+{
+    return "import QtQuick 2.6\n"
+           "import Stoiridh.Controls.Private 1.0\n"
+           "import Stoiridh.Controls.Tests 1.0\n\n"
+           "Item {\n"
+           + generateControl("StressControl")
+           + generateControl("OtherStressControl") +
+           "}\n";
+}
+
+// returns the value of the environment variable `name` if it is a positive integer, otherwise,
+// `defaultValue`.
+int environmentValue(const char *name, int defaultValue)
+{
+    bool ok{false};
+    const int value = qEnvironmentVariableIntValue(name, &ok);
+
+    return (ok && value > 0) ? value : defaultValue;
+}
+
+// runs a QML engine that creates, styles and destroys controls at random until the deadline, and
+// tears its engine down from time to time.
+class StressThread final : public QThread
+{
+public:
+    StressThread(int duration, unsigned int seed)
+        : m_duration{duration}
+        , m_seed{seed}
+    {
+    }
+
+    qint64 operations() const noexcept { return m_operations; }
+    int engines() const noexcept { return m_engines; }
+    qint64 elapsed() const noexcept { return m_elapsed; }
+    QStringList errors() const { return m_errors; }
+
+protected:
+    void run() override
+    {
+        std::mt19937 random{m_seed};
+        std::uniform_int_distribution<int> action{0, 99};
+
+        auto pick = [&random](int count) {
+            return std::uniform_int_distribution<int>{0, count - 1}(random);
+        };
+
+        QElapsedTimer timer{};
+        timer.start();
+
+        const auto qml = generateDocument();
+
+        while (timer.elapsed() < m_duration && m_errors.isEmpty())
+        {
+            QScopedPointer<QQmlEngine> engine{new QQmlEngine{}};
+            SCT::Bootstrap::QmlExtensionPlugin::init(engine.data());
+            ++m_engines;
+
+            QQmlComponent component{engine.data()};
+            component.setData(qml, QUrl{QStringLiteral("file:///tests/controls.qml")});
+
+            if (!component.isReady())
+            {
+                m_errors << component.errorString();
+                break;
+            }
+
+            QList<QObject *> roots{};
+            QList<StressControl *> controls{};
+
+            // tear the engine down with a probability of 1% per action.
+            for (int value = action(random); value > 0 && timer.elapsed() < m_duration;
+                 value = action(random))
+            {
+                if (value < 30 || controls.isEmpty())
+                {
+                    auto *const root = component.create();
+
+                    if (!root)
+                    {
+                        m_errors << component.errorString();
+                        break;
+                    }
+
+                    roots << root;
+                    controls << root->findChildren<StressControl *>();
+                }
+                else if (value < 90)
+                {
+                    auto *const control = controls.at(pick(controls.count()));
+                    control->setState(static_cast<StressControl::State>(pick(4)));
+                }
+                else
+                {
+                    auto *const root = roots.takeAt(pick(roots.count()));
+
+                    controls.erase(std::remove_if(controls.begin(), controls.end(),
+                                                  [root](StressControl *control) {
+                                                      return control->parent() == root;
+                                                  }),
+                                   controls.end());
+                    delete root;
+                }
+
+                ++m_operations;
+            }
+
+            controls.clear();
+            qDeleteAll(roots);
+        }
+
+        m_elapsed = timer.elapsed();
+    }
+
+private:
+    const int m_duration;
+    const unsigned int m_seed;
+    qint64 m_operations{};
+    int m_engines{};
+    qint64 m_elapsed{};
+    QStringList m_errors{};
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCase                                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class TestSCTStress : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void engineIsolation();
+    void engines();
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Tests                                                                                         //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSCTStress::initTestCase()
+{
+    // the QML types are registered once, before any engine is created.
+    SCT::Bootstrap::QmlExtensionPlugin::qmlRegisterInternalTypes("Stoiridh.Controls.Private");
+    qmlRegisterType<StressControl>("Stoiridh.Controls.Tests", 1, 0, "StressControl");
+    qmlRegisterType<OtherStressControl>("Stoiridh.Controls.Tests", 1, 0, "OtherStressControl");
+}
+
+void TestSCTStress::engineIsolation()
+{
+    QScopedPointer<QQmlEngine> engineA{new QQmlEngine{}};
+    QQmlEngine engineB{};
+    SCT::Bootstrap::QmlExtensionPlugin::init(engineA.data());
+    SCT::Bootstrap::QmlExtensionPlugin::init(&engineB);
+
+    QQmlComponent componentA{engineA.data()};
+    componentA.setData(generateDocument(), QUrl{QStringLiteral("file:///tests/a.qml")});
+    QQmlComponent componentB{&engineB};
+    componentB.setData(generateDocument(), QUrl{QStringLiteral("file:///tests/b.qml")});
+
+    QScopedPointer<QObject> rootA{componentA.create()};
+    QScopedPointer<QObject> rootB{componentB.create()};
+    QVERIFY(rootA);
+    QVERIFY(rootB);
+
+    // the styles are not shared between the engines
+    const auto dispatchersA = SCT::StyleFactory::dispatchers(engineA.data());
+    const auto dispatchersB = SCT::StyleFactory::dispatchers(&engineB);
+    QCOMPARE(dispatchersA.count(), 2);
+    QCOMPARE(dispatchersB.count(), 2);
+
+    for (auto cit = dispatchersA.cbegin(); cit != dispatchersA.cend(); ++cit)
+    {
+        QVERIFY(dispatchersB.contains(cit.key()));
+        QVERIFY(dispatchersB.value(cit.key()) != cit.value());
+    }
+
+    // the destruction of an engine does not destroy the styles of the other engines
+    rootA.reset();
+    const auto *const destroyedEngine = engineA.data();
+    engineA.reset();
+
+    QVERIFY(SCT::StyleFactory::dispatchers(destroyedEngine).isEmpty());
+    QCOMPARE(SCT::StyleFactory::dispatchers(&engineB).count(), 2);
+
+    auto *const control = rootB->findChild<StressControl *>();
+    QVERIFY(control);
+
+    control->setState(StressControl::State::Pressed);
+    QCOMPARE(control->content()->width(), 20.0);
+}
+
+void TestSCTStress::engines()
+{
+    const int threadCount = environmentValue("SCT_STRESS_ENGINES",
+                                             qBound(2, QThread::idealThreadCount(), 8));
+    const int duration = environmentValue("SCT_STRESS_DURATION", 2000);
+    const auto seed = static_cast<unsigned int>(environmentValue("SCT_STRESS_SEED", 1));
+
+    QList<StressThread *> threads{};
+
+    for (int i = 0; i < threadCount; ++i)
+    {
+        threads << new StressThread{duration, seed + static_cast<unsigned int>(i)};
+    }
+
+    for (auto *const thread : threads)
+    {
+        thread->start();
+    }
+
+    qint64 operations{};
+
+    for (int i = 0; i < threads.count(); ++i)
+    {
+        auto *const thread = threads.at(i);
+        QVERIFY(thread->wait());
+
+        const auto seconds = qMax<qint64>(thread->elapsed(), 1) / 1000.0;
+
+        qDebug().noquote() << QStringLiteral("thread %1: %2 operations/s, %3 engines")
+                              .arg(i)
+                              .arg(thread->operations() / seconds, 0, 'f', 0)
+                              .arg(thread->engines());
+
+        QVERIFY2(thread->errors().isEmpty(), qPrintable(thread->errors().join(QLatin1Char('\n'))));
+        QVERIFY(thread->operations() > 0);
+
+        operations += thread->operations();
+    }
+
+    qDebug().noquote() << QStringLiteral("%1 threads: %2 operations/s")
+                          .arg(threadCount)
+                          .arg(operations / (duration / 1000.0), 0, 'f', 0);
+
+    qDeleteAll(threads);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Run                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QTEST_MAIN(TestSCTStress)
+#include "tst_sct_stress.moc"
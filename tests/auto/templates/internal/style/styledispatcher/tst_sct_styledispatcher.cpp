@@ -0,0 +1,227 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <QtTest>
+
+#include <QtGui/QColor>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+#include <QtQuick/QQuickItem>
+
+#include <StoiridhControlsTemplates/Control>
+
+#include <StoiridhControlsTemplates/internal/style/stylescheduler.hpp>
+#include <StoiridhControlsTemplates/private/bootstrap/qmlextensionplugin_p.hpp>
+#include <StoiridhControlsTemplates/private/control_p.hpp>
+
+#include <cstddef>
+
+namespace SCT = StoiridhControlsTemplates;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// counts the allocations of the main thread only, so that the threads of the QML engine do not
+// disturb the measure.
+static thread_local quint64 allocations{0};
+
+#if defined(__GLIBC__)
+#define SCT_COUNT_ALLOCATIONS
+
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *pointer, std::size_t size);
+}
+
+// the definitions of the executable interpose those of the C library, so that the allocations of
+// the Qt containers are counted as well as those made by operator new.
+extern "C" void *malloc(std::size_t size) noexcept
+{
+    ++allocations;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(std::size_t count, std::size_t size) noexcept
+{
+    ++allocations;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, std::size_t size) noexcept
+{
+    ++allocations;
+    return __libc_realloc(pointer, size);
+}
+#endif
+
+class StatefulControl : public SCT::Control
+{
+    Q_OBJECT
+
+public:
+    enum class State { Normal, Hovered, Pressed };
+    Q_ENUM(State)
+
+    explicit StatefulControl(QQuickItem *parent = nullptr)
+        : SCT::Control{parent}
+    {
+    }
+
+    void setState(State state)
+    {
+        SCT::ControlPrivate::get(this)->updateStyleState(state);
+    }
+};
+
+static const char *const statefulControlQml = R"(
+import QtQuick 2.6
+import Stoiridh.Controls.Private 1.0
+import Stoiridh.Controls.Tests 1.0
+
+StatefulControl {
+    background: Rectangle {}
+    content: Item {}
+
+    style: Style {
+        StyleState {
+            StylePropertyChanges { target: background; width: 10; height: 10; color: "red" }
+            StylePropertyChanges { target: content; width: 5 }
+        }
+        StyleState {
+            name: "Hovered"
+            StylePropertyChanges { target: background; width: 20; opacity: 0.5; color: "blue" }
+        }
+        StyleState {
+            name: "Pressed"
+            StylePropertyChanges { target: content; width: 30 }
+        }
+    }
+}
+)";
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCase                                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class TestSCTStyleDispatcher : public QObject
+{
+    Q_OBJECT
+
+private:
+    StatefulControl *create();
+
+private slots:
+    void initTestCase();
+
+    void dispatch();
+    void steadyStateAllocations();
+
+private:
+    QQmlEngine m_engine{};
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+StatefulControl *TestSCTStyleDispatcher::create()
+{
+    QQmlComponent component{&m_engine};
+    component.setData(statefulControlQml, QUrl{QStringLiteral("file:///tests/control.qml")});
+
+    auto *const control = qobject_cast<StatefulControl *>(component.create());
+
+    if (!control)
+        qWarning() << component.errors();
+
+    return control;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Tests                                                                                         //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSCTStyleDispatcher::initTestCase()
+{
+    SCT::Bootstrap::QmlExtensionPlugin::qmlRegisterInternalTypes("Stoiridh.Controls.Private");
+    SCT::Bootstrap::QmlExtensionPlugin::init(&m_engine);
+    qmlRegisterType<StatefulControl>("Stoiridh.Controls.Tests", 1, 0, "StatefulControl");
+
+    // the style's states are applied synchronously.
+    SCT::StyleScheduler::instance()->setEnabled(false);
+}
+
+void TestSCTStyleDispatcher::dispatch()
+{
+    QScopedPointer<StatefulControl> control{create()};
+    QVERIFY(control);
+
+    auto *const background = control->background();
+    auto *const content = control->content();
+
+    control->setState(StatefulControl::State::Hovered);
+    QCOMPARE(background->width(), 20.0);
+    QCOMPARE(background->height(), 10.0);
+    QCOMPARE(background->opacity(), 0.5);
+    QCOMPARE(background->property("color").value<QColor>(), QColor{Qt::blue});
+    QCOMPARE(content->width(), 5.0);
+
+    // the default style's state is applied before any other style's states
+    control->setState(StatefulControl::State::Pressed);
+    QCOMPARE(background->width(), 10.0);
+    QCOMPARE(background->property("color").value<QColor>(), QColor{Qt::red});
+    QCOMPARE(content->width(), 30.0);
+
+    control->setState(StatefulControl::State::Normal);
+    QCOMPARE(background->width(), 10.0);
+    QCOMPARE(content->width(), 5.0);
+}
+
+void TestSCTStyleDispatcher::steadyStateAllocations()
+{
+#ifndef SCT_COUNT_ALLOCATIONS
+    QSKIP("the allocations of the C library cannot be counted on this platform");
+#endif
+
+    QScopedPointer<StatefulControl> control{create()};
+    QVERIFY(control);
+
+    const StatefulControl::State states[] = {
+        StatefulControl::State::Hovered,
+        StatefulControl::State::Pressed,
+        StatefulControl::State::Normal
+    };
+
+    // the first switches resolve the properties written by the style's states.
+    for (const auto state : states)
+    {
+        control->setState(state);
+    }
+
+    const auto count = allocations;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        for (const auto state : states)
+        {
+            control->setState(state);
+        }
+    }
+
+    QCOMPARE(allocations - count, quint64{0});
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Run                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QTEST_MAIN(TestSCTStyleDispatcher)
+#include "tst_sct_styledispatcher.moc"
@@ -0,0 +1,532 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <QtTest>
+
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+#include <QtQml/QQmlIncubator>
+#include <QtQuick/QQuickItem>
+
+#include <StoiridhControlsTemplates/Control>
+
+#include <StoiridhControlsTemplates/internal/style/abstractstyledispatcher.hpp>
+#include <StoiridhControlsTemplates/internal/style/style.hpp>
+#include <StoiridhControlsTemplates/internal/style/stylefactory.hpp>
+#include <StoiridhControlsTemplates/internal/style/stylepropertyexpression.hpp>
+#include <StoiridhControlsTemplates/internal/style/stylescheduler.hpp>
+#include <StoiridhControlsTemplates/internal/style/stylestatecontroller.hpp>
+#include <StoiridhControlsTemplates/internal/style/stylestateoperation.hpp>
+#include <StoiridhControlsTemplates/internal/style/stylewarmup.hpp>
+#include <StoiridhControlsTemplates/internal/style/utility/stylefactoryhelper.hpp>
+#include <StoiridhControlsTemplates/private/bootstrap/qmlextensionplugin_p.hpp>
+#include <StoiridhControlsTemplates/private/control_p.hpp>
+#include <StoiridhControlsTemplates/private/style/style_p.hpp>
+
+namespace SCT = StoiridhControlsTemplates;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class StatefulControl : public SCT::Control
+{
+    Q_OBJECT
+
+public:
+    enum class State { Normal, Hovered };
+    Q_ENUM(State)
+
+    explicit StatefulControl(QQuickItem *parent = nullptr)
+        : SCT::Control{parent}
+    {
+    }
+};
+
+class IncubationController final : public QQmlIncubationController
+{
+};
+
+// generates a scene holding `controls` styled controls named "control0", "control1", etc.
+QByteArray generateScene(int controls)
+{
+    QByteArray qml{};
+    qml += "import QtQuick 2.6\n";
+    qml += "import Stoiridh.Controls.Private 1.0\n";
+    qml += "import Stoiridh.Controls.Tests 1.0\n\n";
+    qml += "Item {\n";
+
+    for (int i = 0; i < controls; ++i)
+    {
+        qml += "    StatefulControl {\n";
+        qml += "        objectName: \"control" + QByteArray::number(i) + "\"\n";
+        qml += "        background: Rectangle {}\n";
+        qml += "        style: Style {\n";
+        qml += "            StyleState {\n";
+        qml += "                name: \"Normal\"\n";
+        qml += "                StylePropertyChanges { target: background; width: 10 }\n";
+        qml += "            }\n";
+        qml += "            StyleState {\n";
+        qml += "                name: \"Hovered\"\n";
+        qml += "                StylePropertyChanges { target: background; width: 20 }\n";
+        qml += "            }\n";
+        qml += "        }\n";
+        qml += "    }\n";
+    }
+
+    qml += "}\n";
+
+    return qml;
+}
+
+SCT::Style *styleOf(StatefulControl *control)
+{
+    return control ? SCT::ControlPrivate::get(control)->style() : nullptr;
+}
+
+// returns the controls mapped by the expressions of the style.
+QSet<const SCT::Control *> mappedControls(SCT::Style *style)
+{
+    QSet<const SCT::Control *> controls{};
+    auto *const controller = style ? SCT::StylePrivate::get(style)->stateController() : nullptr;
+
+    if (!controller)
+        return controls;
+
+    for (auto cit = controller->cbegin(); cit != controller->cend(); ++cit)
+    {
+        const auto &operation = cit->second;
+
+        for (auto eit = operation->cbegin(); eit != operation->cend(); ++eit)
+        {
+            for (const auto *control : (*eit)->controls())
+            {
+                controls.insert(control);
+            }
+        }
+    }
+
+    return controls;
+}
+
+// processes the jobs posted to the style scheduler, i.e., the steps of the incremental creation.
+void processStyleJobs()
+{
+    auto *const scheduler = SCT::StyleScheduler::instance();
+
+    while (!scheduler->isEmpty())
+        scheduler->processFrame();
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCase                                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class TestSCTStyleFactory : public QObject
+{
+    Q_OBJECT
+
+private:
+    QObject *create(const QByteArray &qml);
+    QObject *incubate(const QByteArray &qml);
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void createIncrementally();
+    void createDuringIncubation();
+    void taskOwnerDestroyed();
+    void createNextStyleStateOperation();
+    void reuseAfterDestroy();
+
+    void cachedTypes();
+    void dynamicTypes();
+    void destroyTypes();
+
+    void destroyControl();
+    void destroyStylesFirst();
+    void destroyOnQuit();
+
+    void warmUp();
+
+private:
+    IncubationController m_controller{};
+    QQmlEngine m_engine{};
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QObject *TestSCTStyleFactory::create(const QByteArray &qml)
+{
+    QQmlComponent component{&m_engine};
+    component.setData(qml, QUrl{QStringLiteral("file:///tests/scene.qml")});
+
+    auto *const object = component.create();
+
+    if (!object)
+        qWarning() << component.errors();
+
+    return object;
+}
+
+// creates the scene with an asynchronous incubator, so that the styles are created incrementally.
+QObject *TestSCTStyleFactory::incubate(const QByteArray &qml)
+{
+    QQmlComponent component{&m_engine};
+    component.setData(qml, QUrl{QStringLiteral("file:///tests/scene.qml")});
+
+    QQmlIncubator incubator{QQmlIncubator::Asynchronous};
+    component.create(incubator);
+
+    while (incubator.isLoading())
+        m_controller.incubateFor(1000);
+
+    if (!incubator.isReady())
+    {
+        qWarning() << component.errors() << incubator.errors();
+        return nullptr;
+    }
+
+    return incubator.object();
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Tests                                                                                         //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSCTStyleFactory::initTestCase()
+{
+    SCT::Bootstrap::QmlExtensionPlugin::qmlRegisterInternalTypes("Stoiridh.Controls.Private");
+    SCT::Bootstrap::QmlExtensionPlugin::init(&m_engine);
+    qmlRegisterType<StatefulControl>("Stoiridh.Controls.Tests", 1, 0, "StatefulControl");
+
+    m_engine.setIncubationController(&m_controller);
+
+    // the style's states are applied synchronously.
+    SCT::StyleScheduler::instance()->setEnabled(false);
+}
+
+void TestSCTStyleFactory::cleanup()
+{
+    processStyleJobs();
+    SCT::StyleFactory::destroy(&m_engine);
+}
+
+void TestSCTStyleFactory::createIncrementally()
+{
+    QScopedPointer<QObject> root{incubate(generateScene(2))};
+    QVERIFY(root);
+
+    auto *const owner = root->findChild<StatefulControl *>(QStringLiteral("control0"));
+    auto *const other = root->findChild<StatefulControl *>(QStringLiteral("control1"));
+    QVERIFY(owner);
+    QVERIFY(other);
+
+    // the styles are created by the style scheduler, once the controls are complete.
+    QVERIFY(SCT::StyleFactory::dispatchers(&m_engine).isEmpty());
+    QVERIFY(!SCT::StylePrivate::get(styleOf(owner))->styleDispatcher());
+
+    processStyleJobs();
+
+    const auto dispatchers = SCT::StyleFactory::dispatchers(&m_engine);
+    QCOMPARE(dispatchers.count(), 1);
+
+    // the style of the owner of the task is shared with the other control.
+    auto *const style = dispatchers.cbegin().value()->style();
+    QCOMPARE(styleOf(owner), style);
+    QCOMPARE(styleOf(other), style);
+}
+
+void TestSCTStyleFactory::createDuringIncubation()
+{
+    QQmlComponent component{&m_engine};
+    component.setData(generateScene(1), QUrl{QStringLiteral("file:///tests/scene.qml")});
+
+    QQmlIncubator incubator{QQmlIncubator::Asynchronous};
+    component.create(incubator);
+    QVERIFY(incubator.isLoading());
+    QVERIFY(m_controller.incubatingObjectCount() > 0);
+
+    // a control created synchronously while another scene is incubating is styled at once.
+    QScopedPointer<QObject> root{create(generateScene(1))};
+    QVERIFY(root);
+
+    auto *const control = root->findChild<StatefulControl *>(QStringLiteral("control0"));
+    QVERIFY(control);
+    QVERIFY(SCT::StylePrivate::get(styleOf(control))->styleDispatcher());
+
+    incubator.clear();
+}
+
+void TestSCTStyleFactory::taskOwnerDestroyed()
+{
+    QScopedPointer<QObject> root{incubate(generateScene(2))};
+    QVERIFY(root);
+
+    auto *const owner = root->findChild<StatefulControl *>(QStringLiteral("control0"));
+    auto *const other = root->findChild<StatefulControl *>(QStringLiteral("control1"));
+    QVERIFY(owner);
+    QVERIFY(other);
+
+    // a budget of 0ms processes a single step per frame.
+    auto *const scheduler = SCT::StyleScheduler::instance();
+    const auto frameBudget = scheduler->frameBudget();
+    scheduler->setFrameBudget(0);
+
+    scheduler->processFrame();
+    QVERIFY(!scheduler->isEmpty());
+
+    // the task restarts with the next request.
+    delete owner;
+
+    processStyleJobs();
+    scheduler->setFrameBudget(frameBudget);
+
+    const auto dispatchers = SCT::StyleFactory::dispatchers(&m_engine);
+    QCOMPARE(dispatchers.count(), 1);
+    QCOMPARE(styleOf(other), dispatchers.cbegin().value()->style());
+}
+
+void TestSCTStyleFactory::createNextStyleStateOperation()
+{
+    QScopedPointer<QObject> root{incubate(generateScene(1))};
+    QVERIFY(root);
+
+    auto *const control = root->findChild<StatefulControl *>(QStringLiteral("control0"));
+    QVERIFY(control);
+
+    auto *const controller = SCT::StylePrivate::get(styleOf(control))->stateController();
+    QVERIFY(controller);
+    QVERIFY(controller->isEmpty());
+
+    SCT::StyleFactoryHelper helper{control};
+
+    // the default style state operation is created first.
+    QVERIFY(helper.createNextStyleStateOperation());
+    QVERIFY(controller->defaultStateOperation());
+    QVERIFY(!controller->findStateOperation(QStringLiteral("Normal")));
+
+    QVERIFY(helper.createNextStyleStateOperation());
+    QVERIFY(controller->findStateOperation(QStringLiteral("Normal")));
+    QVERIFY(!controller->findStateOperation(QStringLiteral("Hovered")));
+
+    // the last step.
+    QVERIFY(!helper.createNextStyleStateOperation());
+    QVERIFY(controller->findStateOperation(QStringLiteral("Hovered")));
+    QCOMPARE(controller->count(), 3);
+
+    // no step remains.
+    QVERIFY(!helper.createNextStyleStateOperation());
+    QCOMPARE(controller->count(), 3);
+
+    // the pending task is discarded with the control.
+    root.reset();
+}
+
+void TestSCTStyleFactory::reuseAfterDestroy()
+{
+    QScopedPointer<QObject> first{create(generateScene(1))};
+    QVERIFY(first);
+
+    // the style is registered, so the reuse is posted to the style scheduler.
+    QScopedPointer<QObject> pending{incubate(generateScene(1))};
+    QVERIFY(pending);
+
+    auto *const control = pending->findChild<StatefulControl *>(QStringLiteral("control0"));
+    QVERIFY(control);
+
+    first.reset();
+    SCT::StyleFactory::destroy(&m_engine);
+
+    // the registry created afterwards for the same QML engine is not the one of the pending reuse.
+    QScopedPointer<QObject> second{create(generateScene(1))};
+    QVERIFY(second);
+
+    processStyleJobs();
+
+    QVERIFY(!SCT::StylePrivate::get(styleOf(control))->styleDispatcher());
+    QCOMPARE(SCT::StyleFactory::dispatchers(&m_engine).count(), 1);
+}
+
+void TestSCTStyleFactory::cachedTypes()
+{
+    QScopedPointer<QObject> root{create(generateScene(2))};
+    QVERIFY(root);
+
+    auto *const first = root->findChild<StatefulControl *>(QStringLiteral("control0"));
+    auto *const second = root->findChild<StatefulControl *>(QStringLiteral("control1"));
+    QVERIFY(first);
+    QVERIFY(second);
+
+    // the controls of a C++ type share the dispatcher cached for their meta-object.
+    const auto types = SCT::StyleFactory::types(&m_engine);
+    QCOMPARE(types.count(), 1);
+    QVERIFY(types.contains(&StatefulControl::staticMetaObject));
+
+    auto *const dispatcher = types.value(&StatefulControl::staticMetaObject);
+    QCOMPARE(styleOf(first), dispatcher->style());
+    QCOMPARE(styleOf(second), dispatcher->style());
+    QCOMPARE(SCT::StyleFactory::dispatchers(&m_engine).count(), 1);
+}
+
+void TestSCTStyleFactory::dynamicTypes()
+{
+    // the declared property gives a dynamic meta-object to each control.
+    auto qml = generateScene(2);
+    qml.replace("    StatefulControl {\n",
+                "    StatefulControl {\n        property int extra: 0\n");
+
+    QScopedPointer<QObject> root{create(qml)};
+    QVERIFY(root);
+
+    auto *const first = root->findChild<StatefulControl *>(QStringLiteral("control0"));
+    auto *const second = root->findChild<StatefulControl *>(QStringLiteral("control1"));
+    QVERIFY(first);
+    QVERIFY(second);
+    QVERIFY(first->metaObject() != &StatefulControl::staticMetaObject);
+
+    // the controls of a QML declaration share the dispatcher cached for their property cache.
+    const auto types = SCT::StyleFactory::types(&m_engine);
+    QCOMPARE(types.count(), 1);
+    QVERIFY(!types.contains(&StatefulControl::staticMetaObject));
+    QVERIFY(!types.contains(first->metaObject()));
+
+    QCOMPARE(types.cbegin().value()->style(), styleOf(first));
+    QCOMPARE(SCT::StyleFactory::dispatchers(&m_engine).count(), 1);
+    QCOMPARE(styleOf(first), styleOf(second));
+}
+
+void TestSCTStyleFactory::destroyTypes()
+{
+    QScopedPointer<QObject> root{create(generateScene(1))};
+    QVERIFY(root);
+    QCOMPARE(SCT::StyleFactory::types(&m_engine).count(), 1);
+
+    root.reset();
+    SCT::StyleFactory::destroy(&m_engine);
+
+    // the cached meta-objects are discarded with the registry of the QML engine.
+    QVERIFY(SCT::StyleFactory::types(&m_engine).isEmpty());
+    QVERIFY(SCT::StyleFactory::dispatchers(&m_engine).isEmpty());
+}
+
+void TestSCTStyleFactory::destroyControl()
+{
+    QScopedPointer<QObject> root{create(generateScene(2))};
+    QVERIFY(root);
+
+    auto *const first = root->findChild<StatefulControl *>(QStringLiteral("control0"));
+    auto *const second = root->findChild<StatefulControl *>(QStringLiteral("control1"));
+    QVERIFY(first);
+    QVERIFY(second);
+
+    auto *const style = styleOf(second);
+    QCOMPARE(mappedControls(style).count(), 2);
+
+    // a control destroyed while its style lives removes its mappings.
+    const SCT::Control *const destroyed = first;
+    delete first;
+
+    const auto controls = mappedControls(style);
+    QVERIFY(!controls.contains(destroyed));
+    QVERIFY(controls.contains(second));
+}
+
+void TestSCTStyleFactory::destroyStylesFirst()
+{
+    QScopedPointer<QObject> root{create(generateScene(2))};
+    QVERIFY(root);
+
+    auto *const control = root->findChild<StatefulControl *>(QStringLiteral("control0"));
+    QVERIFY(control);
+    QVERIFY(styleOf(control));
+
+    // the controls whose style is destroyed have nothing to unmap.
+    SCT::StyleFactory::destroy(&m_engine);
+    QVERIFY(!styleOf(control));
+    QVERIFY(SCT::StyleFactory::dispatchers(&m_engine).isEmpty());
+
+    root.reset();
+
+    // the QML engine still creates the styles of the next scene.
+    QScopedPointer<QObject> next{create(generateScene(1))};
+    QVERIFY(next);
+
+    auto *const other = next->findChild<StatefulControl *>(QStringLiteral("control0"));
+    QVERIFY(other);
+    QVERIFY(SCT::StylePrivate::get(styleOf(other))->styleDispatcher());
+    QCOMPARE(SCT::StyleFactory::dispatchers(&m_engine).count(), 1);
+}
+
+void TestSCTStyleFactory::destroyOnQuit()
+{
+    QScopedPointer<QObject> root{create(generateScene(2))};
+    QVERIFY(root);
+
+    auto *const first = root->findChild<StatefulControl *>(QStringLiteral("control0"));
+    auto *const second = root->findChild<StatefulControl *>(QStringLiteral("control1"));
+    QVERIFY(first);
+    QVERIFY(second);
+    QVERIFY(styleOf(first));
+
+    // the styles are destroyed before the QML engine destroys its scene.
+    QVERIFY(QMetaObject::invokeMethod(QCoreApplication::instance(), "aboutToQuit"));
+
+    QVERIFY(SCT::StyleFactory::dispatchers(&m_engine).isEmpty());
+    QVERIFY(!styleOf(first));
+    QVERIFY(!styleOf(second));
+
+    root.reset();
+}
+
+void TestSCTStyleFactory::warmUp()
+{
+    QQmlComponent component{&m_engine};
+    component.setData(generateScene(1), QUrl{QStringLiteral("file:///tests/scene.qml")});
+    QVERIFY(component.isReady());
+
+    QScopedPointer<SCT::StyleWarmUp> warmUp{SCT::StyleFactory::warmUp({&component})};
+    QSignalSpy finished{warmUp.data(), &SCT::StyleWarmUp::finished};
+    QVERIFY(warmUp->isRunning());
+
+    QElapsedTimer timer{};
+    timer.start();
+
+    while (finished.isEmpty() && timer.elapsed() < 5000)
+    {
+        m_controller.incubateFor(10);
+        processStyleJobs();
+        QCoreApplication::processEvents();
+    }
+
+    QCOMPARE(finished.count(), 1);
+
+    // the style of the control type is registered once the warm-up is finished.
+    const auto dispatchers = SCT::StyleFactory::dispatchers(&m_engine);
+    QCOMPARE(dispatchers.count(), 1);
+
+    // a control of the same type created later reuses the style of the warm-up.
+    QScopedPointer<QObject> root{create(generateScene(1))};
+    QVERIFY(root);
+
+    auto *const control = root->findChild<StatefulControl *>(QStringLiteral("control0"));
+    QVERIFY(control);
+    QCOMPARE(styleOf(control), dispatchers.cbegin().value()->style());
+    QCOMPARE(SCT::StyleFactory::dispatchers(&m_engine), dispatchers);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Run                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QTEST_MAIN(TestSCTStyleFactory)
+#include "tst_sct_stylefactory.moc"
@@ -0,0 +1,232 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <QtTest>
+
+#include <QtCore/QSharedPointer>
+#include <QtQuick/QQuickItem>
+
+#include <StoiridhControlsTemplates/Control>
+
+#include <StoiridhControlsTemplates/internal/style/style.hpp>
+#include <StoiridhControlsTemplates/internal/style/stylestatecontroller.hpp>
+#include <StoiridhControlsTemplates/internal/style/utility/stylepool.hpp>
+
+#include <array>
+#include <stdexcept>
+
+namespace SCT = StoiridhControlsTemplates;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+struct Tracker
+{
+    explicit Tracker(QVector<int> *destroyed, int id = 0)
+        : destroyed{destroyed}
+        , id{id}
+    {
+    }
+
+    ~Tracker()
+    {
+        destroyed->append(id);
+    }
+
+    QVector<int> *destroyed;
+    int id;
+};
+
+#ifndef QT_NO_EXCEPTIONS
+struct Throwing
+{
+    Throwing()
+    {
+        throw std::runtime_error{"Throwing"};
+    }
+};
+#endif
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCase                                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class TestSCTStylePool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void create();
+    void createShared();
+    void destroy();
+    void alignment();
+    void slabs();
+    void exception();
+
+    void stateController();
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Tests                                                                                         //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSCTStylePool::create()
+{
+    SCT::StylePool pool{};
+    QVERIFY(pool.isEmpty());
+    QCOMPARE(pool.count(), 0);
+    QCOMPARE(pool.slabCount(), 0);
+    QCOMPARE(pool.capacity(), qint64{0});
+
+    auto *const operation = pool.create<SCT::StyleStateOperation>(QStringLiteral("operation"));
+    auto *const expression = pool.create<SCT::StylePropertyExpression>();
+
+    QVERIFY(operation);
+    QVERIFY(expression);
+    QCOMPARE(operation->name(), QStringLiteral("operation"));
+    QVERIFY(expression->isEmpty());
+
+    QVERIFY(!pool.isEmpty());
+    QCOMPARE(pool.count(), 2);
+    QCOMPARE(pool.slabCount(), 1);
+    QCOMPARE(pool.capacity(), static_cast<qint64>(SCT::StylePool::DefaultSlabSize));
+
+    // objects created one after the other are contiguous in the slab.
+    const auto *const first = reinterpret_cast<const char *>(operation);
+    const auto *const second = reinterpret_cast<const char *>(expression);
+    QVERIFY(second >= first + sizeof(SCT::StyleStateOperation));
+    QVERIFY(second < first + sizeof(SCT::StyleStateOperation) + alignof(std::max_align_t));
+}
+
+void TestSCTStylePool::createShared()
+{
+    QVector<int> destroyed{};
+    QSharedPointer<Tracker> tracker{};
+
+    {
+        auto pool = QSharedPointer<SCT::StylePool>::create();
+        tracker = SCT::StylePool::createShared<Tracker>(pool, &destroyed, 1);
+        QCOMPARE(pool->count(), 1);
+    }
+
+    // the shared pointer keeps the pool alive.
+    QVERIFY(destroyed.isEmpty());
+    QCOMPARE(tracker->id, 1);
+
+    tracker.reset();
+    QCOMPARE(destroyed, QVector<int>{1});
+}
+
+void TestSCTStylePool::destroy()
+{
+    QVector<int> destroyed{};
+
+    {
+        SCT::StylePool pool{};
+
+        for (int i = 0; i < 4; ++i)
+        {
+            pool.create<Tracker>(&destroyed, i);
+        }
+
+        QVERIFY(destroyed.isEmpty());
+    }
+
+    // the objects are destroyed in the reverse order of their creation.
+    QCOMPARE(destroyed, (QVector<int>{3, 2, 1, 0}));
+}
+
+void TestSCTStylePool::alignment()
+{
+    SCT::StylePool pool{};
+
+    pool.create<char>('a');
+    auto *const value = pool.create<double>(1.0);
+    pool.create<char>('b');
+    auto *const pointer = pool.create<void *>(nullptr);
+
+    QCOMPARE(reinterpret_cast<quintptr>(value) % alignof(double), quintptr{0});
+    QCOMPARE(reinterpret_cast<quintptr>(pointer) % alignof(void *), quintptr{0});
+    QCOMPARE(*value, 1.0);
+}
+
+void TestSCTStylePool::slabs()
+{
+    SCT::StylePool pool{64};
+
+    for (int i = 0; i < 16; ++i)
+    {
+        pool.create<qint64>(i);
+    }
+
+    QCOMPARE(pool.count(), 16);
+    QCOMPARE(pool.slabCount(), 2);
+    QCOMPARE(pool.capacity(), qint64{128});
+
+    // an object larger than a slab gets a dedicated slab.
+    pool.create<std::array<char, 256>>();
+    QCOMPARE(pool.slabCount(), 3);
+    QCOMPARE(pool.capacity(), qint64{128 + 256});
+}
+
+void TestSCTStylePool::exception()
+{
+#ifdef QT_NO_EXCEPTIONS
+    QSKIP("the exceptions are disabled");
+#else
+    QVector<int> destroyed{};
+
+    {
+        SCT::StylePool pool{};
+        pool.create<Tracker>(&destroyed, 1);
+
+        QVERIFY_EXCEPTION_THROWN(pool.create<Throwing>(), std::runtime_error);
+        QCOMPARE(pool.count(), 1);
+    }
+
+    QCOMPARE(destroyed, QVector<int>{1});
+#endif
+}
+
+void TestSCTStylePool::stateController()
+{
+    QScopedPointer<SCT::Style> style{new SCT::Style{}};
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+    control->setBackground(new QQuickItem{control.data()});
+
+    SCT::StyleStateController controller{style.data()};
+    auto &pool = controller.pool();
+    QVERIFY(pool.isEmpty());
+
+    auto *const operation = controller.createStateOperation();
+    auto *const expression = pool.create<SCT::StylePropertyExpression>();
+    expression->addMapping(control.data(), control->background());
+    expression->addProperty(QStringLiteral("width"), 42.0);
+    operation->addExpression(expression);
+
+    QCOMPARE(pool.count(), 2);
+    QCOMPARE(controller.defaultStateOperation(), operation);
+    QCOMPARE(controller.apply(control.data()), 1);
+    QCOMPARE(control->background()->width(), 42.0);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Run                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QTEST_APPLESS_MAIN(TestSCTStylePool)
+#include "tst_sct_stylepool.moc"
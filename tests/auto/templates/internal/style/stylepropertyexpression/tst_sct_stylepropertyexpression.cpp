@@ -21,6 +21,7 @@
 #include <QtQuick/QQuickItem>
 
 #include <StoiridhControlsTemplates/Control>
+#include <StoiridhControlsTemplates/Core/Exception/ExceptionHandler>
 #include <StoiridhControlsTemplates/Core/Exception/NullPointerException>
 
 #include <StoiridhControlsTemplates/internal/style/stylepropertyexpression.hpp>
@@ -53,14 +54,19 @@ private slots:
     void addProperty();
     void addProperties();
     void removeProperty();
+    void properties();
 
     void apply();
+    void applyChangedProperties();
+    void applyControls();
 
     void opAssignmentCopy();
     void opAssignmentMove();
 
     void opBinaryComparisonEqual();
     void opBinaryComparisonNotEqual();
+
+    void hash();
 };
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //  Tests                                                                                         //
@@ -155,6 +161,10 @@ void TestSCTStylePropertyExpression::containsTarget()
     QVERIFY(!expression.containsTarget(nullptr, nullptr));
     QVERIFY(!expression.containsTarget(control.data(), nullptr));
     QVERIFY(!expression.containsTarget(nullptr, target.data()));
+
+    // a control that isn't mapped doesn't contain any target
+    QScopedPointer<const SCT::Control> other{new SCT::Control{}};
+    QVERIFY(!expression.containsTarget(other.data(), target.data()));
 }
 
 void TestSCTStylePropertyExpression::addMapping()
@@ -167,13 +177,20 @@ void TestSCTStylePropertyExpression::addMapping()
     expression.addMapping(control.data(), target.data());
     QCOMPARE(expression.count(), qMakePair(1, 0));
 
-    // attempt to add a null control to the expression
-    QVERIFY_EXCEPTION_THROWN(expression.addMapping(nullptr, target.data()), SCT::NullPointerException);
-    QCOMPARE(expression.count(), qMakePair(1, 0));
-
-    // attempt to add a null target to the expression
-    QVERIFY_EXCEPTION_THROWN(expression.addMapping(control.data(), nullptr), SCT::NullPointerException);
-    QCOMPARE(expression.count(), qMakePair(1, 0));
+#ifndef QT_NO_EXCEPTIONS
+    if (SCT::ExceptionHandler::policy == SCT::ErrorPolicy::Throw)
+    {
+        // attempt to add a null control to the expression
+        QVERIFY_EXCEPTION_THROWN(expression.addMapping(nullptr, target.data()),
+                                 SCT::NullPointerException);
+        QCOMPARE(expression.count(), qMakePair(1, 0));
+
+        // attempt to add a null target to the expression
+        QVERIFY_EXCEPTION_THROWN(expression.addMapping(control.data(), nullptr),
+                                 SCT::NullPointerException);
+        QCOMPARE(expression.count(), qMakePair(1, 0));
+    }
+#endif
 }
 
 void TestSCTStylePropertyExpression::removeMapping()
@@ -218,7 +235,10 @@ void TestSCTStylePropertyExpression::addProperty()
     QVERIFY(expression.containsProperty(propertyB.first));
 
     // a property has always a non-empty name
-    QVERIFY_EXCEPTION_THROWN(expression.addProperty({}, {}), std::invalid_argument);
+#ifndef QT_NO_EXCEPTIONS
+    if (SCT::ExceptionHandler::policy == SCT::ErrorPolicy::Throw)
+        QVERIFY_EXCEPTION_THROWN(expression.addProperty({}, {}), std::invalid_argument);
+#endif
 }
 
 void TestSCTStylePropertyExpression::addProperties()
@@ -262,6 +282,43 @@ void TestSCTStylePropertyExpression::removeProperty()
     QCOMPARE(expression.count(), qMakePair(0, 0));
 }
 
+void TestSCTStylePropertyExpression::properties()
+{
+    SCT::StylePropertyExpression expressionA{};
+    SCT::StylePropertyExpression expressionB{};
+
+    expressionA.addProperty(QStringLiteral("color"), QColor{Qt::blue});
+    expressionA.addProperty(QStringLiteral("radius"), 6.0);
+    expressionB.addProperty(QStringLiteral("color"), QColor{Qt::blue});
+    expressionB.addProperty(QStringLiteral("radius"), 6.0);
+
+    // the same values are interned once and shared by the expressions.
+    QCOMPARE(expressionA.property(QStringLiteral("color")),
+             expressionB.property(QStringLiteral("color")));
+    QCOMPARE(expressionA.property(QStringLiteral("color")).value(), QVariant{QColor{Qt::blue}});
+    QCOMPARE(expressionA.property(QStringLiteral("radius")).value(), QVariant{6.0});
+    QVERIFY(!expressionA.property(QStringLiteral("border.width")).isValid());
+    QVERIFY(expressionA == expressionB);
+
+    // the properties are sorted by name, whatever the order in which they have been added.
+    expressionA.addProperty(QStringLiteral("border.width"), 2.0);
+    expressionA.addProperty(QStringLiteral("opacity"), 0.5);
+
+    const auto &properties = expressionA.properties();
+    QCOMPARE(properties.count(), 4);
+    QCOMPARE(properties.at(0).first, QStringLiteral("border.width"));
+    QCOMPARE(properties.at(1).first, QStringLiteral("color"));
+    QCOMPARE(properties.at(2).first, QStringLiteral("opacity"));
+    QCOMPARE(properties.at(3).first, QStringLiteral("radius"));
+
+    expressionA.removeProperty(QStringLiteral("border.width"));
+    expressionA.removeProperty(QStringLiteral("opacity"));
+    QVERIFY(expressionA == expressionB);
+
+    expressionB.addProperty(QStringLiteral("radius"), 8.0);
+    QVERIFY(expressionA != expressionB);
+}
+
 void TestSCTStylePropertyExpression::apply()
 {
     SCT::StylePropertyExpression expression{};
@@ -283,7 +340,70 @@ void TestSCTStylePropertyExpression::apply()
     QCOMPARE(control->background()->height(), 25.0);
 
     // attempt to apply a null pointer in an expression
-    QVERIFY_EXCEPTION_THROWN(expression.apply(nullptr), SCT::NullPointerException);
+#ifndef QT_NO_EXCEPTIONS
+    if (SCT::ExceptionHandler::policy == SCT::ErrorPolicy::Throw)
+        QVERIFY_EXCEPTION_THROWN(expression.apply(nullptr), SCT::NullPointerException);
+#endif
+}
+
+void TestSCTStylePropertyExpression::applyChangedProperties()
+{
+    SCT::StylePropertyExpression expression{};
+
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+    QScopedPointer<QQuickItem> background{new QQuickItem{control.data()}};
+    control->setBackground(background.data());
+
+    expression.addMapping(control.data(), background.data());
+    expression.addProperty(qMakePair(QStringLiteral("width"), 75.0));
+
+    QVERIFY(expression.apply(control.data()));
+    QCOMPARE(control->background()->width(), 75.0);
+
+    // the properties added after an application are applied too
+    expression.addProperty(qMakePair(QStringLiteral("height"), QVariant{QStringLiteral("25")}));
+
+    QVERIFY(expression.apply(control.data()));
+    QCOMPARE(control->background()->height(), 25.0);
+
+    // whereas the removed properties are not
+    QVERIFY(expression.removeProperty(QStringLiteral("width")));
+    control->background()->setWidth(10.0);
+
+    QVERIFY(expression.apply(control.data()));
+    QCOMPARE(control->background()->width(), 10.0);
+}
+
+void TestSCTStylePropertyExpression::applyControls()
+{
+    SCT::StylePropertyExpression expression{};
+
+    QScopedPointer<SCT::Control> controlA{new SCT::Control{}};
+    QScopedPointer<SCT::Control> controlB{new SCT::Control{}};
+    QScopedPointer<QQuickItem> targetA{new QQuickItem{}};
+    QScopedPointer<QQuickItem> targetB{new QQuickItem{}};
+
+    expression.addMapping(controlA.data(), targetA.data());
+    expression.addMapping(controlB.data(), targetB.data());
+    expression.addProperty(qMakePair(QStringLiteral("width"), 75.0));
+    expression.addProperty(qMakePair(QStringLiteral("height"), QVariant{QStringLiteral("25")}));
+
+    // the targets of the same type share the resolved properties
+    int writes{0};
+
+    QVERIFY(expression.applyUnchecked(controlA.data(), &writes));
+    QVERIFY(expression.applyUnchecked(controlB.data(), &writes));
+    QCOMPARE(writes, 4);
+
+    QCOMPARE(targetA->width(), 75.0);
+    QCOMPARE(targetA->height(), 25.0);
+    QCOMPARE(targetB->width(), 75.0);
+    QCOMPARE(targetB->height(), 25.0);
+
+    // a property that the type of the target doesn't declare isn't written
+    expression.addProperty(qMakePair(QStringLiteral("unknown"), 1));
+
+    QVERIFY(!expression.apply(controlA.data()));
 }
 
 void TestSCTStylePropertyExpression::opAssignmentCopy()
@@ -358,6 +478,31 @@ void TestSCTStylePropertyExpression::opBinaryComparisonNotEqual()
 
     QVERIFY(expressionA != expressionB);
 }
+
+void TestSCTStylePropertyExpression::hash()
+{
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+    QScopedPointer<QQuickItem> target{new QQuickItem{}};
+
+    SCT::StylePropertyExpression expressionA{};
+    SCT::StylePropertyExpression expressionB{};
+
+    expressionA.addMapping(control.data(), target.data());
+    expressionA.addProperty(QStringLiteral("width"), 75.0);
+    expressionA.addProperty(QStringLiteral("height"), 25.0);
+
+    // the order in which the properties are added doesn't matter.
+    expressionB.addMapping(control.data(), target.data());
+    expressionB.addProperty(QStringLiteral("height"), 25.0);
+    expressionB.addProperty(QStringLiteral("width"), 75.0);
+
+    QVERIFY(expressionA == expressionB);
+    QCOMPARE(qHash(expressionA), qHash(expressionB));
+    QCOMPARE(qHash(expressionA, 42u), qHash(expressionB, 42u));
+
+    expressionB.addProperty(QStringLiteral("opacity"), 0.5);
+    QVERIFY(qHash(expressionA) != qHash(expressionB));
+}
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //  Run                                                                                           //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,297 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <QtTest>
+
+#include <QtCore/QScopedPointer>
+#include <QtCore/QStringList>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickWindow>
+
+#include <StoiridhControlsTemplates/internal/style/stylescheduler.hpp>
+
+namespace SCT = StoiridhControlsTemplates;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCase                                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class TestSCTStyleScheduler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void constructor();
+
+    void schedule();
+    void scheduleDisabled();
+    void scheduleDestroyedItem();
+
+    void post();
+
+    void processFrame_data();
+    void processFrame();
+
+    void onScreenFirst();
+    void windowFrames();
+
+    void setEnabled();
+    void settled();
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Tests                                                                                         //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSCTStyleScheduler::initTestCase()
+{
+    qunsetenv("SCT_STYLE_FRAME_BUDGET");
+}
+
+void TestSCTStyleScheduler::constructor()
+{
+    SCT::StyleScheduler scheduler{};
+
+    QVERIFY(!scheduler.isEnabled());
+    QVERIFY(scheduler.isEmpty());
+    QCOMPARE(scheduler.count(), 0);
+    QCOMPARE(scheduler.frameBudget(), 8);
+    QCOMPARE(scheduler.lastSettleFrameCount(), 0);
+}
+
+void TestSCTStyleScheduler::schedule()
+{
+    SCT::StyleScheduler scheduler{};
+    scheduler.setEnabled(true);
+
+    QQuickItem item{};
+    int calls{};
+
+    scheduler.schedule(&item, [&calls]() { ++calls; });
+    scheduler.schedule(&item, [&calls]() { ++calls; });
+
+    QCOMPARE(calls, 0);
+    QCOMPARE(scheduler.count(), 2);
+
+    scheduler.processFrame();
+
+    QCOMPARE(calls, 2);
+    QVERIFY(scheduler.isEmpty());
+
+    // a null item is never scheduled
+    scheduler.schedule(nullptr, [&calls]() { ++calls; });
+    QVERIFY(scheduler.isEmpty());
+}
+
+void TestSCTStyleScheduler::scheduleDisabled()
+{
+    SCT::StyleScheduler scheduler{};
+
+    QQuickItem item{};
+    int calls{};
+
+    scheduler.schedule(&item, [&calls]() { ++calls; });
+
+    QCOMPARE(calls, 1);
+    QVERIFY(scheduler.isEmpty());
+}
+
+void TestSCTStyleScheduler::scheduleDestroyedItem()
+{
+    SCT::StyleScheduler scheduler{};
+    scheduler.setEnabled(true);
+
+    QScopedPointer<QQuickItem> item{new QQuickItem{}};
+    int calls{};
+
+    scheduler.schedule(item.data(), [&calls]() { ++calls; });
+    item.reset();
+
+    scheduler.processFrame();
+
+    QCOMPARE(calls, 0);
+    QVERIFY(scheduler.isEmpty());
+}
+
+void TestSCTStyleScheduler::post()
+{
+    SCT::StyleScheduler scheduler{};
+
+    QQuickItem item{};
+    QStringList order{};
+
+    // a posted job is deferred even if the scheduler is disabled
+    scheduler.post([&order]() { order << QStringLiteral("job"); });
+    scheduler.post(&item, [&order]() { order << QStringLiteral("item"); });
+
+    QVERIFY(order.isEmpty());
+    QCOMPARE(scheduler.count(), 2);
+
+    scheduler.processFrame();
+
+    QCOMPARE(order, (QStringList{QStringLiteral("job"), QStringLiteral("item")}));
+    QVERIFY(scheduler.isEmpty());
+}
+
+void TestSCTStyleScheduler::processFrame_data()
+{
+    QTest::addColumn<int>("jobs");
+    QTest::addColumn<int>("frameBudget");
+    QTest::addColumn<int>("expectedFrames");
+
+    QTest::newRow("Budget 0ms, 1 job")      <<  1 <<    0 <<  1;
+    QTest::newRow("Budget 0ms, 16 jobs")    << 16 <<    0 << 16;
+    QTest::newRow("Budget 1000ms, 16 jobs") << 16 << 1000 <<  1;
+}
+
+void TestSCTStyleScheduler::processFrame()
+{
+    QFETCH(int, jobs);
+    QFETCH(int, frameBudget);
+    QFETCH(int, expectedFrames);
+
+    SCT::StyleScheduler scheduler{};
+    scheduler.setEnabled(true);
+    scheduler.setFrameBudget(frameBudget);
+
+    QQuickItem item{};
+    int calls{};
+
+    for (int i = 0; i < jobs; ++i)
+        scheduler.schedule(&item, [&calls]() { ++calls; });
+
+    int frames{};
+
+    while (!scheduler.isEmpty())
+    {
+        scheduler.processFrame();
+        ++frames;
+    }
+
+    QCOMPARE(calls, jobs);
+    QCOMPARE(frames, expectedFrames);
+    QCOMPARE(scheduler.lastSettleFrameCount(), expectedFrames);
+}
+
+void TestSCTStyleScheduler::onScreenFirst()
+{
+    QQuickWindow window{};
+    window.resize(200, 200);
+
+    auto *const offScreen = new QQuickItem{window.contentItem()};
+    offScreen->setPosition(QPointF{1000.0, 1000.0});
+    offScreen->setSize(QSizeF{50.0, 50.0});
+
+    auto *const onScreen = new QQuickItem{window.contentItem()};
+    onScreen->setPosition(QPointF{10.0, 10.0});
+    onScreen->setSize(QSizeF{50.0, 50.0});
+
+    SCT::StyleScheduler scheduler{};
+    scheduler.setEnabled(true);
+    scheduler.setFrameBudget(0);
+
+    QStringList order{};
+
+    scheduler.schedule(offScreen, [&order]() { order << QStringLiteral("offScreen"); });
+    scheduler.schedule(onScreen, [&order]() { order << QStringLiteral("onScreen"); });
+
+    scheduler.processFrame();
+    QCOMPARE(order, QStringList{QStringLiteral("onScreen")});
+
+    scheduler.processFrame();
+    QCOMPARE(order, (QStringList{QStringLiteral("onScreen"), QStringLiteral("offScreen")}));
+}
+
+void TestSCTStyleScheduler::windowFrames()
+{
+    QQuickWindow window{};
+    window.resize(200, 200);
+    window.show();
+
+    if (!QTest::qWaitForWindowExposed(&window))
+        QSKIP("the window cannot be exposed on this platform");
+
+    auto *const item = new QQuickItem{window.contentItem()};
+    item->setSize(QSizeF{50.0, 50.0});
+
+    SCT::StyleScheduler scheduler{};
+    scheduler.setEnabled(true);
+    scheduler.setFrameBudget(0);
+
+    QSignalSpy frames{&window, &QQuickWindow::afterAnimating};
+    QSignalSpy settled{&scheduler, &SCT::StyleScheduler::settled};
+    QVector<int> processedFrames{};
+
+    for (int i = 0; i < 3; ++i)
+        scheduler.schedule(item, [&]() { processedFrames << frames.count(); });
+
+    // each job is processed in its own rendered frame of the window.
+    QTRY_COMPARE(settled.count(), 1);
+    QCOMPARE(processedFrames.count(), 3);
+    QVERIFY(processedFrames.at(0) > 0);
+    QVERIFY(processedFrames.at(0) < processedFrames.at(1));
+    QVERIFY(processedFrames.at(1) < processedFrames.at(2));
+    QCOMPARE(scheduler.lastSettleFrameCount(), 3);
+}
+
+void TestSCTStyleScheduler::setEnabled()
+{
+    SCT::StyleScheduler scheduler{};
+    scheduler.setEnabled(true);
+    scheduler.setFrameBudget(0);
+
+    QQuickItem item{};
+    int calls{};
+
+    for (int i = 0; i < 4; ++i)
+        scheduler.schedule(&item, [&calls]() { ++calls; });
+
+    // disabling the scheduler processes the pending jobs
+    scheduler.setEnabled(false);
+
+    QVERIFY(!scheduler.isEnabled());
+    QVERIFY(scheduler.isEmpty());
+    QCOMPARE(calls, 4);
+}
+
+void TestSCTStyleScheduler::settled()
+{
+    SCT::StyleScheduler scheduler{};
+    scheduler.setEnabled(true);
+    scheduler.setFrameBudget(0);
+
+    QSignalSpy spy{&scheduler, &SCT::StyleScheduler::settled};
+    QVERIFY(spy.isValid());
+
+    QQuickItem item{};
+    int calls{};
+
+    for (int i = 0; i < 3; ++i)
+        scheduler.schedule(&item, [&calls]() { ++calls; });
+
+    // the pending jobs are processed by the event loop
+    QTRY_COMPARE(spy.count(), 1);
+
+    QCOMPARE(calls, 3);
+    QCOMPARE(spy.at(0).at(0).toInt(), 3);
+    QCOMPARE(scheduler.lastSettleFrameCount(), 3);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Run                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QTEST_MAIN(TestSCTStyleScheduler)
+#include "tst_sct_stylescheduler.moc"
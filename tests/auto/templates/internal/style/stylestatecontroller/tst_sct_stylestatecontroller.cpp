@@ -22,13 +22,34 @@
 #include <QtQuick/QQuickItem>
 
 #include <StoiridhControlsTemplates/Control>
+#include <StoiridhControlsTemplates/Core/Exception/ExceptionHandler>
 #include <StoiridhControlsTemplates/Core/Exception/NullPointerException>
 
 #include <StoiridhControlsTemplates/internal/style/style.hpp>
 #include <StoiridhControlsTemplates/internal/style/stylestatecontroller.hpp>
+#include <StoiridhControlsTemplates/private/control_p.hpp>
 
 namespace SCT = StoiridhControlsTemplates;
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class StatefulControl : public SCT::Control
+{
+    Q_OBJECT
+
+public:
+    enum class State { Normal, Hovered };
+    Q_ENUM(State)
+
+    using SCT::Control::Control;
+
+    void setState(State state)
+    {
+        SCT::ControlPrivate::get(this)->updateStyleState(state);
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //  TestCase                                                                                      //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -50,7 +71,9 @@ private slots:
     void count();
 
     void style();
+    void iterators();
 
+    void createStateOperation();
     void addStateOperation();
 
     void findStateOperation_data();
@@ -59,7 +82,15 @@ private slots:
     void defaultStateOperation_data();
     void defaultStateOperation();
 
+    void shareExpression();
+    void insertExpressionMapping();
+    void insertExpressionMappingControls();
+
+    void removeMapping();
+
     void apply();
+    void applyUnchecked();
+    void applyUncheckedState();
 };
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //  Helpers                                                                                       //
@@ -94,8 +125,13 @@ TestSCTStyleStateController::make_operation(SCT::Control *control)
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 void TestSCTStyleStateController::constructor()
 {
+    if (SCT::ExceptionHandler::policy != SCT::ErrorPolicy::Throw)
+        QSKIP("the library is not built with the Throw error policy");
+
+#ifndef QT_NO_EXCEPTIONS
     QScopedPointer<SCT::Style> style{};
     QVERIFY_EXCEPTION_THROWN(SCT::StyleStateController{style.data()}, SCT::NullPointerException);
+#endif
 }
 
 void TestSCTStyleStateController::isEmpty()
@@ -130,6 +166,52 @@ void TestSCTStyleStateController::style()
     QCOMPARE(controller.style(), style.data());
 }
 
+void TestSCTStyleStateController::iterators()
+{
+    QScopedPointer<SCT::Style> style{new SCT::Style{}};
+    SCT::StyleStateController controller{style.data()};
+    QVERIFY(controller.cbegin() == controller.cend());
+
+    controller.createStateOperation(QStringLiteral("pressed"));
+    controller.createStateOperation();
+    controller.createStateOperation(QStringLiteral("hovered"));
+    controller.addStateOperation(SSOPointer::create(QStringLiteral("disabled")));
+
+    // the operations are sorted by name, the default style state operation first.
+    QStringList names{};
+
+    for (auto cit = controller.cbegin(); cit != controller.cend(); ++cit)
+    {
+        QCOMPARE(cit->second->name(), cit->first);
+        names.append(cit->first);
+    }
+
+    QCOMPARE(names, (QStringList{QString{}, QStringLiteral("disabled"), QStringLiteral("hovered"),
+                                 QStringLiteral("pressed")}));
+}
+
+void TestSCTStyleStateController::createStateOperation()
+{
+    QScopedPointer<SCT::Style> style{new SCT::Style{}};
+    SCT::StyleStateController controller{style.data()};
+
+    auto *const operation = controller.createStateOperation(QStringLiteral("operation"));
+    QVERIFY(operation);
+    QCOMPARE(operation->name(), QStringLiteral("operation"));
+    QCOMPARE(controller.count(), 1);
+    QCOMPARE(controller.findStateOperation(QStringLiteral("operation")), operation);
+    QCOMPARE(controller.pool().count(), 1);
+
+    // an operation registered under the same name is replaced.
+    controller.addStateOperation(SSOPointer::create(QStringLiteral("operation")));
+    QCOMPARE(controller.count(), 1);
+    QVERIFY(controller.findStateOperation(QStringLiteral("operation")) != operation);
+
+    auto *const other = controller.createStateOperation(QStringLiteral("operation"));
+    QCOMPARE(controller.count(), 1);
+    QCOMPARE(controller.findStateOperation(QStringLiteral("operation")), other);
+}
+
 void TestSCTStyleStateController::addStateOperation()
 {
     QScopedPointer<SCT::Style> style{new SCT::Style{}};
@@ -141,7 +223,7 @@ void TestSCTStyleStateController::addStateOperation()
     controller.addStateOperation(std::move(operation));
 
     QCOMPARE(controller.count(), 1);
-    QVERIFY(!controller.findStateOperation(operationName).isNull());
+    QVERIFY(controller.findStateOperation(operationName) != nullptr);
 }
 
 void TestSCTStyleStateController::findStateOperation_data()
@@ -181,7 +263,7 @@ void TestSCTStyleStateController::findStateOperation()
     controller.addStateOperation(std::move(operation));
 
     QCOMPARE(controller.count(), 1);
-    QCOMPARE(!controller.findStateOperation(operationName).isNull(), found);
+    QCOMPARE(controller.findStateOperation(operationName) != nullptr, found);
 }
 
 void TestSCTStyleStateController::defaultStateOperation_data()
@@ -208,7 +290,167 @@ void TestSCTStyleStateController::defaultStateOperation()
     controller.addStateOperation(std::move(operation));
 
     QCOMPARE(controller.count(), 1);
-    QCOMPARE(!controller.defaultStateOperation().isNull(), found);
+    QCOMPARE(controller.defaultStateOperation() != nullptr, found);
+}
+
+void TestSCTStyleStateController::shareExpression()
+{
+    QScopedPointer<SCT::Style> style{new SCT::Style{}};
+    SCT::StyleStateController controller{style.data()};
+
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+    control->setBackground(new QQuickItem{control.data()});
+
+    auto make_expression = [&control](qreal width)
+    {
+        SCT::StylePropertyExpression expression{};
+        expression.addMapping(control.data(), control->background());
+        expression.addProperty(QStringLiteral("width"), width);
+
+        return expression;
+    };
+
+    auto *const expressionA = controller.shareExpression(make_expression(75.0));
+    QVERIFY(expressionA);
+    QCOMPARE(controller.expressionUseCount(expressionA), 1);
+    QCOMPARE(controller.pool().count(), 1);
+
+    // an identical expression is shared instead of being allocated again.
+    auto *const expressionB = controller.shareExpression(make_expression(75.0));
+    QCOMPARE(expressionB, expressionA);
+    QCOMPARE(controller.expressionUseCount(expressionA), 2);
+    QCOMPARE(controller.pool().count(), 1);
+
+    auto *const expressionC = controller.shareExpression(make_expression(64.0));
+    QVERIFY(expressionC != expressionA);
+    QCOMPARE(controller.expressionUseCount(expressionC), 1);
+    QCOMPARE(controller.pool().count(), 2);
+
+    SCT::StylePropertyExpression expression{};
+    QCOMPARE(controller.expressionUseCount(&expression), 0);
+}
+
+void TestSCTStyleStateController::insertExpressionMapping()
+{
+    QScopedPointer<SCT::Style> style{new SCT::Style{}};
+    SCT::StyleStateController controller{style.data()};
+
+    QScopedPointer<SCT::Control> controlA{new SCT::Control{}};
+    QScopedPointer<SCT::Control> controlB{new SCT::Control{}};
+    controlA->setBackground(new QQuickItem{controlA.data()});
+    controlB->setBackground(new QQuickItem{controlB.data()});
+    controlB->setContent(new QQuickItem{controlB.data()});
+
+    SCT::StylePropertyExpression expression{};
+    expression.addMapping(controlA.data(), controlA->background());
+    expression.addProperty(QStringLiteral("width"), 75.0);
+
+    auto *const hovered = controller.createStateOperation(QStringLiteral("hovered"));
+    auto *const pressed = controller.createStateOperation(QStringLiteral("pressed"));
+    hovered->addExpression(controller.shareExpression(SCT::StylePropertyExpression{expression}));
+    pressed->addExpression(controller.shareExpression(SCT::StylePropertyExpression{expression}));
+
+    auto *const shared = hovered->expressionAt(0);
+    QCOMPARE(pressed->expressionAt(0), shared);
+
+    // the same mapping for both operations keeps the expression shared.
+    const auto mappingB = qMakePair(controlB.data(), controlB->background());
+    controller.insertExpressionMapping(hovered, 0, mappingB);
+    controller.insertExpressionMapping(pressed, 0, mappingB);
+    QCOMPARE(hovered->expressionAt(0), shared);
+    QCOMPARE(pressed->expressionAt(0), shared);
+    QCOMPARE(controller.expressionUseCount(shared), 2);
+
+    // a different target detaches the expression of the operation.
+    QScopedPointer<SCT::Control> controlC{new SCT::Control{}};
+    controlC->setBackground(new QQuickItem{controlC.data()});
+    controlC->setContent(new QQuickItem{controlC.data()});
+
+    const auto mappingC = qMakePair(controlC.data(), controlC->background());
+    controller.insertExpressionMapping(hovered, 0, mappingC);
+    controller.insertExpressionMapping(pressed, 0, qMakePair(controlC.data(), controlC->content()));
+
+    auto *const detached = pressed->expressionAt(0);
+    QCOMPARE(hovered->expressionAt(0), shared);
+    QVERIFY(detached != shared);
+    QCOMPARE(controller.expressionUseCount(shared), 1);
+    QCOMPARE(controller.expressionUseCount(detached), 1);
+
+    QVERIFY(shared->containsTarget(controlC.data(), controlC->background()));
+    QVERIFY(detached->containsTarget(controlC.data(), controlC->content()));
+    QVERIFY(detached->containsTarget(controlA.data(), controlA->background()));
+    QVERIFY(detached->containsTarget(controlB.data(), controlB->background()));
+
+    // an expression that isn't shared keeps its first mapping.
+    controller.insertExpressionMapping(pressed, 0, mappingC);
+    QCOMPARE(pressed->expressionAt(0), detached);
+    QVERIFY(detached->containsTarget(controlC.data(), controlC->content()));
+}
+
+void TestSCTStyleStateController::insertExpressionMappingControls()
+{
+    QScopedPointer<SCT::Style> style{new SCT::Style{}};
+    SCT::StyleStateController controller{style.data()};
+
+    QScopedPointer<SCT::Control> controlA{new SCT::Control{}};
+    QScopedPointer<SCT::Control> controlB{new SCT::Control{}};
+    controlA->setBackground(new QQuickItem{controlA.data()});
+    controlB->setBackground(new QQuickItem{controlB.data()});
+
+    SCT::StylePropertyExpression expression{};
+    expression.addMapping(controlA.data(), controlA->background());
+    expression.addProperty(QStringLiteral("width"), 75.0);
+
+    auto *const operation = controller.createStateOperation(QStringLiteral("hovered"));
+    operation->addExpression(controller.shareExpression(SCT::StylePropertyExpression{expression}));
+
+    auto *const shared = operation->expressionAt(0);
+    QVERIFY(!shared->containsTarget(controlB.data(), controlB->background()));
+
+    // the second control is mapped onto the shared expression itself.
+    controller.insertExpressionMapping(operation, 0,
+                                       qMakePair(controlB.data(), controlB->background()));
+
+    QCOMPARE(operation->expressionAt(0), shared);
+    QVERIFY(shared->containsTarget(controlA.data(), controlA->background()));
+    QVERIFY(shared->containsTarget(controlB.data(), controlB->background()));
+
+    // the modified expression is no longer shared, neither by its former value nor by its new one.
+    auto *const former = controller.shareExpression(SCT::StylePropertyExpression{expression});
+    QVERIFY(former != shared);
+    QCOMPARE(*former, expression);
+
+    expression.addMapping(controlB.data(), controlB->background());
+    QCOMPARE(*shared, expression);
+
+    auto *const modified = controller.shareExpression(SCT::StylePropertyExpression{expression});
+    QVERIFY(modified != shared);
+    QCOMPARE(controller.expressionUseCount(shared), 1);
+
+    // the expressions that aren't modified by the removal of a mapping are still shared.
+    controller.removeMapping(controlB.data());
+    QVERIFY(!shared->containsControl(controlB.data()));
+    QVERIFY(controller.shareExpression(SCT::StylePropertyExpression{*former}) == former);
+}
+
+void TestSCTStyleStateController::removeMapping()
+{
+    QScopedPointer<SCT::Style> style{new SCT::Style{}};
+    SCT::StyleStateController controller{style.data()};
+
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+
+    controller.addStateOperation(TestSCTStyleStateController::make_operation(control.data()));
+
+    auto *const operation = controller.defaultStateOperation();
+    QVERIFY(operation);
+    QVERIFY(operation->expressionAt(0)->containsControl(control.data()));
+    QVERIFY(operation->expressionAt(1)->containsControl(control.data()));
+
+    controller.removeMapping(control.data());
+
+    QVERIFY(!operation->expressionAt(0)->containsControl(control.data()));
+    QVERIFY(!operation->expressionAt(1)->containsControl(control.data()));
 }
 
 void TestSCTStyleStateController::apply()
@@ -221,7 +463,7 @@ void TestSCTStyleStateController::apply()
     auto operation = TestSCTStyleStateController::make_operation(control.data());
 
     controller.addStateOperation(std::move(operation));
-    controller.apply(control.data());
+    QCOMPARE(controller.apply(control.data()), 4);
 
     QCOMPARE(control->background()->width(), 75.0);
     QCOMPARE(control->background()->height(), 25.0);
@@ -230,7 +472,61 @@ void TestSCTStyleStateController::apply()
     QCOMPARE(control->content()->height(), 64.0);
 
     // attempt to apply a null pointer to a controller
-    QVERIFY_EXCEPTION_THROWN(controller.apply(nullptr), SCT::NullPointerException);
+#ifndef QT_NO_EXCEPTIONS
+    if (SCT::ExceptionHandler::policy == SCT::ErrorPolicy::Throw)
+        QVERIFY_EXCEPTION_THROWN(controller.apply(nullptr), SCT::NullPointerException);
+#endif
+}
+
+void TestSCTStyleStateController::applyUnchecked()
+{
+    QScopedPointer<SCT::Style> style{new SCT::Style{}};
+    SCT::StyleStateController controller{style.data()};
+
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+
+    controller.addStateOperation(TestSCTStyleStateController::make_operation(control.data()));
+    QCOMPARE(controller.applyUnchecked(control.data()), 4);
+
+    QCOMPARE(control->background()->width(), 75.0);
+    QCOMPARE(control->background()->height(), 25.0);
+
+    QCOMPARE(control->content()->width(), 64.0);
+    QCOMPARE(control->content()->height(), 64.0);
+
+    // the unchecked path writes the same properties as the checked one.
+    QCOMPARE(controller.apply(control.data()), controller.applyUnchecked(control.data()));
+}
+
+void TestSCTStyleStateController::applyUncheckedState()
+{
+    QScopedPointer<SCT::Style> style{new SCT::Style{}};
+    SCT::StyleStateController controller{style.data()};
+
+    QScopedPointer<StatefulControl> control{new StatefulControl{}};
+    controller.addStateOperation(TestSCTStyleStateController::make_operation(control.data()));
+
+    // the write of the unknown property fails after the write of the width.
+    auto expression = SPEPointer::create();
+    expression->addMapping(control.data(), control->background());
+    expression->addProperty(QStringLiteral("width"), 100.0);
+    expression->addProperty(QStringLiteral("widthUnknown"), 1);
+
+    auto hovered = SSOPointer::create(QStringLiteral("Hovered"));
+    hovered->addExpression(std::move(expression));
+    controller.addStateOperation(std::move(hovered));
+
+    // without an operation for the style's state, only the default operation is applied.
+    control->setState(StatefulControl::State::Normal);
+    QCOMPARE(controller.applyUnchecked(control.data()), 4);
+    QCOMPARE(control->background()->width(), 75.0);
+
+    // the operation of the style's state is applied after the default one.
+    control->setState(StatefulControl::State::Hovered);
+    QCOMPARE(controller.applyUnchecked(control.data()), 5);
+    QCOMPARE(control->background()->width(), 100.0);
+    QCOMPARE(control->background()->height(), 25.0);
+    QCOMPARE(control->content()->width(), 64.0);
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //  Run                                                                                           //
@@ -22,6 +22,7 @@
 #include <QtQuick/QQuickItem>
 
 #include <StoiridhControlsTemplates/Control>
+#include <StoiridhControlsTemplates/Core/Exception/ExceptionHandler>
 #include <StoiridhControlsTemplates/Core/Exception/NullPointerException>
 
 #include <StoiridhControlsTemplates/internal/style/stylestateoperation.hpp>
@@ -52,9 +53,11 @@ private slots:
 
     void addExpression();
     void insertExpressionMapping();
+    void removeMapping();
     void expressionAt();
 
     void apply();
+    void applyPartially();
 
     void opAssignmentCopy();
     void opAssignmentMove();
@@ -175,8 +178,33 @@ void TestSCTStyleStateOperation::insertExpressionMapping()
 
     operation.insertExpressionMapping(1, mapping);
 
-    QCOMPARE(operation.expressionAt(0).lock()->count(), qMakePair(0, 0));
-    QCOMPARE(operation.expressionAt(1).lock()->count(), qMakePair(1, 0));
+    QCOMPARE(operation.expressionAt(0)->count(), qMakePair(0, 0));
+    QCOMPARE(operation.expressionAt(1)->count(), qMakePair(1, 0));
+}
+
+void TestSCTStyleStateOperation::removeMapping()
+{
+    QScopedPointer<SCT::Control> controlA{new SCT::Control{}};
+    QScopedPointer<SCT::Control> controlB{new SCT::Control{}};
+    QScopedPointer<QQuickItem> target{new QQuickItem{}};
+
+    SCT::StyleStateOperation operation{};
+    operation.addExpression(SPEPointer::create());
+    operation.addExpression(SPEPointer::create());
+
+    operation.insertExpressionMapping(0, qMakePair(controlA.data(), target.data()));
+    operation.insertExpressionMapping(1, qMakePair(controlA.data(), target.data()));
+    operation.insertExpressionMapping(1, qMakePair(controlB.data(), target.data()));
+
+    QVERIFY(operation.removeMapping(controlA.data()));
+
+    QCOMPARE(operation.expressionAt(0)->count(), qMakePair(0, 0));
+    QCOMPARE(operation.expressionAt(1)->count(), qMakePair(1, 0));
+    QVERIFY(operation.expressionAt(1)->containsControl(controlB.data()));
+
+    // there is not mapping for the control anymore
+    QVERIFY(!operation.removeMapping(controlA.data()));
+    QVERIFY(!operation.removeMapping(nullptr));
 }
 
 void TestSCTStyleStateOperation::expressionAt()
@@ -191,7 +219,7 @@ void TestSCTStyleStateOperation::expressionAt()
     operation.addExpression(std::move(expression));
     QCOMPARE(operation.count(), 1);
 
-    if (auto expression = operation.expressionAt(0).lock())
+    if (auto *const expression = operation.expressionAt(0))
     {
         QVERIFY(expression->containsTarget(control.data(), target.data()));
     }
@@ -220,7 +248,7 @@ void TestSCTStyleStateOperation::apply()
 
     operation.addExpression(std::move(expressionA));
     operation.addExpression(std::move(expressionB));
-    operation.apply(control.data());
+    QCOMPARE(operation.apply(control.data()), 4);
 
     QCOMPARE(control->background()->width(), 75.0);
     QCOMPARE(control->background()->height(), 25.0);
@@ -229,7 +257,32 @@ void TestSCTStyleStateOperation::apply()
     QCOMPARE(control->content()->height(), 64.0);
 
     // attempt to apply a null pointer in an operation
-    QVERIFY_EXCEPTION_THROWN(operation.apply(nullptr), SCT::NullPointerException);
+#ifndef QT_NO_EXCEPTIONS
+    if (SCT::ExceptionHandler::policy == SCT::ErrorPolicy::Throw)
+        QVERIFY_EXCEPTION_THROWN(operation.apply(nullptr), SCT::NullPointerException);
+#endif
+}
+
+void TestSCTStyleStateOperation::applyPartially()
+{
+    SCT::StyleStateOperation operation{};
+
+    QScopedPointer<SCT::Control> control{new SCT::Control{}};
+    QScopedPointer<QQuickItem> background{new QQuickItem{control.data()}};
+
+    control->setBackground(background.data());
+
+    // the properties are written by name, so the unknown property fails after the height.
+    auto expression = SPEPointer::create();
+    expression->addMapping(control.data(), background.data());
+    expression->addProperty(QStringLiteral("height"), 25.0);
+    expression->addProperty(QStringLiteral("unknownProperty"), 50.0);
+
+    operation.addExpression(std::move(expression));
+
+    // the writes performed before the failure are reported.
+    QCOMPARE(operation.apply(control.data()), 1);
+    QCOMPARE(control->background()->height(), 25.0);
 }
 
 void TestSCTStyleStateOperation::opAssignmentCopy()
@@ -0,0 +1,257 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <QtTest>
+
+#include <QtCore/QPointF>
+#include <QtCore/QRectF>
+#include <QtCore/QSizeF>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <QtGui/QColor>
+
+#include <StoiridhControlsTemplates/internal/style/stylevalue.hpp>
+
+namespace SCT = StoiridhControlsTemplates;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+class InternThread : public QThread
+{
+public:
+    explicit InternThread(int offset)
+        : m_offset{offset}
+    {
+    }
+
+    QVector<int> indexes{};
+
+protected:
+    void run() override
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            // every thread interns the same values, in a different order.
+            const auto value = 1000000.0 + (i + m_offset) % 1000;
+            indexes.append(SCT::StyleValue{value}.index());
+        }
+    }
+
+private:
+    int m_offset;
+};
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCase                                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class TestSCTStyleValue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void invalid();
+    void intern();
+    void types_data();
+    void types();
+    void notANumber();
+    void objects();
+    void hash();
+    void threads();
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Tests                                                                                         //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSCTStyleValue::invalid()
+{
+    SCT::StyleValue value{};
+    QVERIFY(!value.isValid());
+    QCOMPARE(value.index(), -1);
+    QVERIFY(!value.value().isValid());
+
+    const auto count = SCT::StyleValue::count();
+    SCT::StyleValue other{QVariant{}};
+    QVERIFY(!other.isValid());
+    QVERIFY(value == other);
+    QCOMPARE(SCT::StyleValue::count(), count);
+}
+
+void TestSCTStyleValue::intern()
+{
+    const auto count = SCT::StyleValue::count();
+
+    SCT::StyleValue radius{QVariant{4.5}};
+    QVERIFY(radius.isValid());
+    QCOMPARE(SCT::StyleValue::count(), count + 1);
+
+    SCT::StyleValue other{QVariant{4.5}};
+    QVERIFY(radius == other);
+    QCOMPARE(radius.index(), other.index());
+    QCOMPARE(SCT::StyleValue::count(), count + 1);
+
+    SCT::StyleValue different{QVariant{5.5}};
+    QVERIFY(radius != different);
+    QCOMPARE(SCT::StyleValue::count(), count + 2);
+
+    QCOMPARE(radius.value(), QVariant{4.5});
+    QCOMPARE(radius.userType(), static_cast<int>(QMetaType::Double));
+}
+
+void TestSCTStyleValue::types_data()
+{
+    QTest::addColumn<QVariant>("lhs");
+    QTest::addColumn<QVariant>("rhs");
+    QTest::addColumn<bool>("same");
+
+    QTest::newRow("Types 01") << QVariant{12.0} << QVariant{12.0} << true;
+    QTest::newRow("Types 02") << QVariant{12} << QVariant{12.0} << false;
+    QTest::newRow("Types 03") << QVariant{QStringLiteral("12")} << QVariant{12.0} << false;
+    QTest::newRow("Types 04") << QVariant{true} << QVariant{1} << false;
+    QTest::newRow("Types 05") << QVariant{QColor{Qt::red}} << QVariant{QColor{Qt::red}} << true;
+    QTest::newRow("Types 06") << QVariant{QColor{Qt::red}} << QVariant{QStringLiteral("#ff0000")}
+                              << false;
+    QTest::newRow("Types 07") << QVariant{QColor{255, 0, 0, 255}}
+                              << QVariant{QColor{255, 0, 0, 128}}
+                              << false;
+    QTest::newRow("Types 08") << QVariant{QSizeF{4.0, 2.0}} << QVariant{QSizeF{4.0, 2.0}} << true;
+    QTest::newRow("Types 09") << QVariant{QSizeF{4.0, 2.0}} << QVariant{QSizeF{2.0, 4.0}} << false;
+    QTest::newRow("Types 10") << QVariant{QRectF{0.0, 0.0, 4.0, 2.0}}
+                              << QVariant{QRectF{0.0, 0.0, 4.0, 2.0}}
+                              << true;
+    QTest::newRow("Types 11") << QVariant{QRectF{0.0, 0.0, 4.0, 2.0}}
+                              << QVariant{QRectF{1.0, 0.0, 4.0, 2.0}}
+                              << false;
+    QTest::newRow("Types 12") << QVariant{QPointF{1.0, 2.0}} << QVariant{QPointF{1.0, 2.0}} << true;
+    QTest::newRow("Types 13") << QVariant{QVariantList{1.0, QSizeF{4.0, 2.0}}}
+                              << QVariant{QVariantList{1.0, QSizeF{4.0, 2.0}}}
+                              << true;
+    QTest::newRow("Types 14") << QVariant{QVariantList{1.0, QSizeF{4.0, 2.0}}}
+                              << QVariant{QVariantList{1.0, QSizeF{2.0, 4.0}}}
+                              << false;
+}
+
+void TestSCTStyleValue::types()
+{
+    QFETCH(QVariant, lhs);
+    QFETCH(QVariant, rhs);
+    QFETCH(bool, same);
+
+    const SCT::StyleValue a{lhs};
+    const SCT::StyleValue b{rhs};
+
+    QCOMPARE(a == b, same);
+    QCOMPARE(a.userType(), lhs.userType());
+    QCOMPARE(b.userType(), rhs.userType());
+    QCOMPARE(a.value(), lhs);
+    QCOMPARE(b.value(), rhs);
+}
+
+void TestSCTStyleValue::notANumber()
+{
+    const SCT::StyleValue a{QVariant{qQNaN()}};
+    const auto count = SCT::StyleValue::count();
+
+    // a NaN never compares equal, but it is interned once
+    const SCT::StyleValue b{QVariant{qQNaN()}};
+
+    QVERIFY(a == b);
+    QVERIFY(qIsNaN(b.value().toDouble()));
+    QCOMPARE(SCT::StyleValue::count(), count);
+}
+
+void TestSCTStyleValue::objects()
+{
+    const auto count = SCT::StyleValue::count();
+
+    QScopedPointer<QObject> object{new QObject{}};
+
+    const SCT::StyleValue a{QVariant::fromValue(object.data())};
+    const SCT::StyleValue b{QVariant::fromValue(object.data())};
+
+    // the objects aren't interned in the constant pool
+    QVERIFY(a.isValid());
+    QCOMPARE(a.index(), -1);
+    QVERIFY(a == b);
+    QCOMPARE(SCT::StyleValue::count(), count);
+    QCOMPARE(a.userType(), static_cast<int>(QMetaType::QObjectStar));
+    QCOMPARE(a.value().value<QObject *>(), object.data());
+
+    // and a destroyed object is read as a null pointer
+    object.reset();
+
+    QVERIFY(a.isValid());
+    QCOMPARE(a.value().value<QObject *>(), static_cast<QObject *>(nullptr));
+}
+
+void TestSCTStyleValue::hash()
+{
+    QHash<SCT::StyleValue, int> hash{};
+    hash.insert(SCT::StyleValue{QVariant{8.0}}, 1);
+    hash.insert(SCT::StyleValue{QVariant{8.0}}, 2);
+    hash.insert(SCT::StyleValue{QVariant{16.0}}, 3);
+
+    QCOMPARE(hash.count(), 2);
+    QCOMPARE(hash.value(SCT::StyleValue{QVariant{8.0}}), 2);
+}
+
+void TestSCTStyleValue::threads()
+{
+    const auto count = SCT::StyleValue::count();
+
+    QVector<InternThread *> threads{};
+
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.append(new InternThread{i * 250});
+    }
+
+    for (auto *thread : threads)
+    {
+        thread->start();
+    }
+
+    for (auto *thread : threads)
+    {
+        QVERIFY(thread->wait(30000));
+    }
+
+    // each value has been interned once, whatever the thread that interned it first.
+    QCOMPARE(SCT::StyleValue::count(), count + 1000);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        const auto expected = threads.at(0)->indexes.at(i);
+
+        for (int t = 1; t < threads.count(); ++t)
+        {
+            const auto shift = (i + 250 * (4 - t)) % 1000;
+            QCOMPARE(threads.at(t)->indexes.at(shift), expected);
+        }
+    }
+
+    qDeleteAll(threads);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Run                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QTEST_GUILESS_MAIN(TestSCTStyleValue)
+#include "tst_sct_stylevalue.moc"
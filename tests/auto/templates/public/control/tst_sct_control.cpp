@@ -21,8 +21,46 @@
 
 #include <StoiridhControlsTemplates/Control>
 
+#include <StoiridhControlsTemplates/internal/style/abstractstyledispatcher.hpp>
+#include <StoiridhControlsTemplates/internal/style/style.hpp>
+#include <StoiridhControlsTemplates/internal/style/stylescheduler.hpp>
+#include <StoiridhControlsTemplates/private/control_p.hpp>
+
 namespace SCT = StoiridhControlsTemplates;
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class CountingStyleDispatcher final : public SCT::AbstractStyleDispatcher
+{
+public:
+    using SCT::AbstractStyleDispatcher::AbstractStyleDispatcher;
+
+    void dispatch(const SCT::Control *) override
+    {
+        ++count;
+    }
+
+    int count{};
+};
+
+// the values of the states are not their indices in the enumeration.
+class SparseStateControl : public SCT::Control
+{
+    Q_OBJECT
+
+public:
+    enum class State { Normal = 1, Hovered = 4, Pressed = 8 };
+    Q_ENUM(State)
+
+    using SCT::Control::Control;
+
+    void setState(State state)
+    {
+        SCT::ControlPrivate::get(this)->updateStyleState(state);
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //  TestCase                                                                                      //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -48,6 +86,11 @@ private slots:
 
     void geometry_data();
     void geometry();
+
+    void hiddenStyle();
+
+    void styleState_data();
+    void styleState();
 };
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //  Tests                                                                                         //
@@ -800,6 +843,56 @@ void TestSCTControl::geometry()
     QCOMPARE(content->width(), expectedContentGeometry.width());
     QCOMPARE(content->height(), expectedContentGeometry.height());
 }
+void TestSCTControl::hiddenStyle()
+{
+    // the style's states are applied synchronously.
+    SCT::StyleScheduler::instance()->setEnabled(false);
+
+    CountingStyleDispatcher dispatcher{new SCT::Style{}};
+    SCT::Control control{};
+    auto *const d = SCT::ControlPrivate::get(&control);
+
+    control.setVisible(false);
+    d->setStyle(dispatcher.style());
+    QCOMPARE(dispatcher.count, 0);
+
+    // the style's states of a hidden control are deferred.
+    d->updateStyle();
+    d->updateStyle();
+    QCOMPARE(dispatcher.count, 0);
+
+    // only the last style's state is applied once the control becomes visible.
+    control.setVisible(true);
+    QCOMPARE(dispatcher.count, 1);
+
+    // nothing is pending anymore.
+    control.setVisible(false);
+    control.setVisible(true);
+    QCOMPARE(dispatcher.count, 1);
+
+    d->updateStyle();
+    QCOMPARE(dispatcher.count, 2);
+}
+void TestSCTControl::styleState_data()
+{
+    QTest::addColumn<SparseStateControl::State>("state");
+    QTest::addColumn<QString>("name");
+
+    QTest::newRow("Normal") << SparseStateControl::State::Normal << QStringLiteral("Normal");
+    QTest::newRow("Hovered") << SparseStateControl::State::Hovered << QStringLiteral("Hovered");
+    QTest::newRow("Pressed") << SparseStateControl::State::Pressed << QStringLiteral("Pressed");
+}
+
+void TestSCTControl::styleState()
+{
+    QFETCH(SparseStateControl::State, state);
+    QFETCH(QString, name);
+
+    SparseStateControl control{};
+    control.setState(state);
+
+    QCOMPARE(SCT::ControlPrivate::get(&control)->styleState(), name);
+}
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //  Run                                                                                           //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
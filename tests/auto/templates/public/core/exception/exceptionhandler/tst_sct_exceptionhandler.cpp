@@ -20,6 +20,8 @@
 
 #include <StoiridhControlsTemplates/Core/Exception/ExceptionHandler>
 
+#include <stdexcept>
+
 namespace SCT = StoiridhControlsTemplates;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -30,15 +32,80 @@ class TestSCTExceptionHandler : public QObject
     Q_OBJECT
 
 private slots:
+    void defaultErrorPolicy();
+
     void checkNullPointer();
+
+    void throwPolicy();
+    void assertPolicy();
+    void errorCodePolicy();
 };
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //  Tests                                                                                         //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSCTExceptionHandler::defaultErrorPolicy()
+{
+    QVERIFY(SCT::ExceptionHandler::policy == SCT::DefaultErrorPolicy);
+}
+
 void TestSCTExceptionHandler::checkNullPointer()
 {
+    if (SCT::ExceptionHandler::policy != SCT::ErrorPolicy::Throw)
+        QSKIP("the library is not built with the Throw error policy");
+
+#ifndef QT_NO_EXCEPTIONS
     QVERIFY_EXCEPTION_THROWN(SCT::ExceptionHandler::checkNullPointer(nullptr),
                              SCT::NullPointerException);
+#endif
+}
+
+void TestSCTExceptionHandler::throwPolicy()
+{
+#ifdef QT_NO_EXCEPTIONS
+    QSKIP("the exceptions are disabled");
+#else
+    using Handler = SCT::BasicExceptionHandler<SCT::ErrorPolicy::Throw>;
+
+    int value{};
+
+    QVERIFY(Handler::checkNullPointer(&value));
+    QVERIFY_EXCEPTION_THROWN(Handler::checkNullPointer(nullptr), SCT::NullPointerException);
+
+    QVERIFY(Handler::checkArgument(true, QStringLiteral("argument")));
+    QVERIFY_EXCEPTION_THROWN(Handler::checkArgument(false, QStringLiteral("argument")),
+                             std::invalid_argument);
+#endif
+}
+
+void TestSCTExceptionHandler::assertPolicy()
+{
+    using Handler = SCT::BasicExceptionHandler<SCT::ErrorPolicy::Assert>;
+
+    int value{};
+
+    QVERIFY(Handler::checkNullPointer(&value));
+    QVERIFY(Handler::checkArgument(true, QStringLiteral("argument")));
+
+#ifdef QT_NO_DEBUG
+    // without assertions, the errors are reported by the return value.
+    QVERIFY(!Handler::checkNullPointer(nullptr));
+    QVERIFY(!Handler::checkArgument(false, QStringLiteral("argument")));
+#else
+    QSKIP("the Assert error policy aborts on errors in debug builds");
+#endif
+}
+
+void TestSCTExceptionHandler::errorCodePolicy()
+{
+    using Handler = SCT::BasicExceptionHandler<SCT::ErrorPolicy::ErrorCode>;
+
+    int value{};
+
+    QVERIFY(Handler::checkNullPointer(&value));
+    QVERIFY(!Handler::checkNullPointer(nullptr));
+
+    QVERIFY(Handler::checkArgument(true, QStringLiteral("argument")));
+    QVERIFY(!Handler::checkArgument(false, QStringLiteral("argument")));
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //  Run                                                                                           //
@@ -78,6 +78,11 @@ void TestSCTNullPointerException::message()
     QFETCH(QString, expected);
 
     SCT::NullPointerException exception{name, type};
+
+    // the copies keep the message of the exception.
+    QScopedPointer<SCT::NullPointerException> clone{exception.clone()};
+    QCOMPARE(clone->message(), expected);
+
     QCOMPARE(exception.message(), expected);
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,370 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef STOIRIDH_BENCHMARKS_BENCHMARKHARNESS_HPP
+#define STOIRIDH_BENCHMARKS_BENCHMARKHARNESS_HPP
+
+// The benchmark harness records the median, the 95th percentile and the number of allocations of
+// the measured operations, writes them as JSON and compares them to a baseline.
+//
+// Environment variables:
+//
+//  - SCT_BENCHMARK_OUTPUT:    file or directory where the results are written.
+//  - SCT_BENCHMARK_BASELINE:  file or directory holding the results to compare with.
+//  - SCT_BENCHMARK_TOLERANCE: tolerated regression, in percent (default: 10).
+//
+// When a directory is given, the file is named after the benchmark, e.g., bench_sct_control.json.
+//
+// The header replaces the global allocation functions in order to count the allocations; thus, it
+// must be included by a single translation unit of a benchmark, unless
+// SCT_BENCHMARK_NO_ALLOCATION_COUNTING is defined. With the GNU C library, malloc(), calloc() and
+// realloc() are replaced, which counts the allocations of the Qt containers as well; elsewhere,
+// only the allocations made by operator new are counted.
+
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QVector>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Allocations                                                                                   //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+inline std::atomic<quint64> &benchmarkAllocations()
+{
+    static std::atomic<quint64> allocations{0};
+    return allocations;
+}
+
+#ifndef SCT_BENCHMARK_NO_ALLOCATION_COUNTING
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *pointer, std::size_t size);
+}
+
+// the definitions of the executable interpose those of the C library, for the Qt libraries and for
+// operator new as well.
+extern "C" void *malloc(std::size_t size) noexcept
+{
+    benchmarkAllocations().fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(std::size_t count, std::size_t size) noexcept
+{
+    benchmarkAllocations().fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, std::size_t size) noexcept
+{
+    benchmarkAllocations().fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
+#else
+void *operator new(std::size_t size)
+{
+    benchmarkAllocations().fetch_add(1, std::memory_order_relaxed);
+
+    if (auto *const pointer = std::malloc(size > 0 ? size : 1))
+        return pointer;
+
+    throw std::bad_alloc{};
+}
+
+void *operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+#endif // defined(__GLIBC__)
+#endif // SCT_BENCHMARK_NO_ALLOCATION_COUNTING
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Traces                                                                                        //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// sums the duration, in nanoseconds, of the complete events named `name` of a Chrome trace-event
+// array, e.g., the events recorded by the StyleTraceRecorder.
+inline qint64 tracedDuration(const QJsonArray &events, const QString &name)
+{
+    double duration{};
+
+    for (const auto &value : events)
+    {
+        const auto event = value.toObject();
+
+        if (event.value(QStringLiteral("name")).toString() == name)
+            duration += event.value(QStringLiteral("dur")).toDouble();
+    }
+
+    return static_cast<qint64>(duration * 1000.0);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  BenchmarkHarness                                                                              //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class BenchmarkHarness final
+{
+public:
+    struct Result
+    {
+        QString name{};
+        int samples{};
+        qint64 median{};
+        qint64 p95{};
+        double allocations{};
+    };
+
+public:
+    explicit BenchmarkHarness(const QString &name)
+        : m_name{name}
+    {
+        bool ok{false};
+        const auto tolerance = qgetenv("SCT_BENCHMARK_TOLERANCE").toDouble(&ok);
+
+        if (ok && tolerance >= 0.0)
+            m_tolerance = tolerance / 100.0;
+    }
+
+    // measures `samples` times the operation, after a warm-up run that is not recorded.
+    template<typename Operation>
+    Result measure(const QString &name, int samples, Operation &&operation)
+    {
+        Q_ASSERT(samples > 0);
+
+        if (samples <= 0)
+            return empty(name);
+
+        operation();
+
+        QVector<qint64> durations{};
+        durations.reserve(samples);
+
+        const auto allocations = benchmarkAllocations().load(std::memory_order_relaxed);
+
+        for (int i = 0; i < samples; ++i)
+        {
+            QElapsedTimer timer{};
+            timer.start();
+            operation();
+            durations.append(timer.nsecsElapsed());
+        }
+
+        const auto count = benchmarkAllocations().load(std::memory_order_relaxed) - allocations;
+
+        return record(name, durations, count);
+    }
+
+    // records the durations and the total number of allocations of an operation measured by the
+    // benchmark itself, e.g., an operation that cannot be repeated in place.
+    Result record(const QString &name, QVector<qint64> durations, quint64 allocations)
+    {
+        Q_ASSERT(!durations.isEmpty());
+
+        if (durations.isEmpty())
+            return empty(name);
+
+        std::sort(durations.begin(), durations.end());
+
+        const int samples = durations.count();
+
+        Result result{};
+        result.name = name;
+        result.samples = samples;
+        result.median = durations.at(samples / 2);
+        result.p95 = durations.at(qMin(samples - 1, (samples * 95) / 100));
+        result.allocations = static_cast<double>(allocations) / samples;
+
+        m_results.append(result);
+
+        return result;
+    }
+
+    const QVector<Result> &results() const
+    {
+        return m_results;
+    }
+
+    // writes the results and compares them to the baseline, if any. Returns false if a benchmark
+    // has regressed beyond the tolerance; the report describes the comparison.
+    bool finish(QString *report)
+    {
+        bool ok{true};
+
+        const auto output = QString::fromLocal8Bit(qgetenv("SCT_BENCHMARK_OUTPUT"));
+
+        if (!output.isEmpty() && !write(filePath(output)))
+        {
+            report->append(QStringLiteral("unable to write the results to %1\n").arg(output));
+            ok = false;
+        }
+
+        const auto baseline = QString::fromLocal8Bit(qgetenv("SCT_BENCHMARK_BASELINE"));
+
+        if (!baseline.isEmpty())
+            ok = compare(filePath(baseline), report) && ok;
+
+        return ok;
+    }
+
+private:
+    // the result of an operation without any sample, which is not recorded.
+    static Result empty(const QString &name)
+    {
+        Result result{};
+        result.name = name;
+
+        return result;
+    }
+
+    QString filePath(const QString &path) const
+    {
+        if (QFileInfo{path}.isDir())
+            return QDir{path}.filePath(m_name + QStringLiteral(".json"));
+
+        return path;
+    }
+
+    bool write(const QString &filePath) const
+    {
+        QJsonArray results{};
+
+        for (const auto &result : m_results)
+        {
+            results.append(QJsonObject{
+                {QStringLiteral("name"), result.name},
+                {QStringLiteral("samples"), result.samples},
+                {QStringLiteral("median"), static_cast<double>(result.median)},
+                {QStringLiteral("p95"), static_cast<double>(result.p95)},
+                {QStringLiteral("allocations"), result.allocations}
+            });
+        }
+
+        const QJsonObject document{
+            {QStringLiteral("benchmark"), m_name},
+            {QStringLiteral("unit"), QStringLiteral("ns")},
+            {QStringLiteral("results"), results}
+        };
+
+        QFile file{filePath};
+
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            return false;
+
+        return file.write(QJsonDocument{document}.toJson()) > 0;
+    }
+
+    bool compare(const QString &filePath, QString *report) const
+    {
+        QFile file{filePath};
+
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            report->append(QStringLiteral("unable to read the baseline %1\n").arg(filePath));
+            return false;
+        }
+
+        const auto document = QJsonDocument::fromJson(file.readAll()).object();
+        const auto baselines = document.value(QStringLiteral("results")).toArray();
+
+        bool ok{true};
+        QTextStream stream{report};
+
+        stream << QStringLiteral("%1 against %2 (tolerance %3%)\n").arg(m_name)
+                                                                  .arg(filePath)
+                                                                  .arg(m_tolerance * 100.0);
+
+        for (const auto &result : m_results)
+        {
+            const auto it = std::find_if(baselines.begin(), baselines.end(),
+                                         [&result](const QJsonValue &value) {
+                return value.toObject().value(QStringLiteral("name")).toString() == result.name;
+            });
+
+            if (it == baselines.end())
+            {
+                stream << QStringLiteral("  [NEW]  %1\n").arg(result.name);
+                continue;
+            }
+
+            const auto baseline = (*it).toObject();
+            const auto median = baseline.value(QStringLiteral("median")).toDouble();
+            const auto allocations = baseline.value(QStringLiteral("allocations")).toDouble();
+
+            const auto timeRatio = median > 0.0 ? result.median / median : 1.0;
+            const bool slower = timeRatio > 1.0 + m_tolerance;
+            // a fraction of an allocation per iteration is tolerated for the amortised growth of
+            // the containers.
+            const bool allocates = result.allocations > allocations * (1.0 + m_tolerance) + 0.5;
+
+            stream << QStringLiteral("  [%1] %2: median %3 ns (baseline %4 ns, %5%6%), "
+                                     "%7 allocations (baseline %8)\n")
+                      .arg(slower || allocates ? QStringLiteral("FAIL") : QStringLiteral(" OK "))
+                      .arg(result.name)
+                      .arg(result.median)
+                      .arg(median, 0, 'f', 0)
+                      .arg(timeRatio >= 1.0 ? QStringLiteral("+") : QString{})
+                      .arg((timeRatio - 1.0) * 100.0, 0, 'f', 1)
+                      .arg(result.allocations, 0, 'f', 1)
+                      .arg(allocations, 0, 'f', 1);
+
+            ok = ok && !slower && !allocates;
+        }
+
+        return ok;
+    }
+
+private:
+    QString m_name{};
+    double m_tolerance{0.10};
+    QVector<Result> m_results{};
+};
+
+#endif // STOIRIDH_BENCHMARKS_BENCHMARKHARNESS_HPP
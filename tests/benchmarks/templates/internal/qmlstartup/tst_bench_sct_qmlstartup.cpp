@@ -0,0 +1,565 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <QtTest>
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QScopedPointer>
+#include <QtGui/QGuiApplication>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickWindow>
+
+#include <StoiridhControlsTemplates/Control>
+
+#include <StoiridhControlsTemplates/internal/diagnostics/styletracerecorder.hpp>
+#include <StoiridhControlsTemplates/internal/style/stylefactory.hpp>
+#include <StoiridhControlsTemplates/private/bootstrap/qmlextensionplugin_p.hpp>
+
+#include <benchmarkharness.hpp>
+
+namespace SCT = StoiridhControlsTemplates;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// the StyleFactory shares a style between the controls of a same QML type, so each control type of
+// a scene requires its own C++ type.
+class StyledControl01 : public SCT::Control { Q_OBJECT };
+class StyledControl02 : public SCT::Control { Q_OBJECT };
+class StyledControl03 : public SCT::Control { Q_OBJECT };
+class StyledControl04 : public SCT::Control { Q_OBJECT };
+class StyledControl05 : public SCT::Control { Q_OBJECT };
+class StyledControl06 : public SCT::Control { Q_OBJECT };
+class StyledControl07 : public SCT::Control { Q_OBJECT };
+class StyledControl08 : public SCT::Control { Q_OBJECT };
+class StyledControl09 : public SCT::Control { Q_OBJECT };
+class StyledControl10 : public SCT::Control { Q_OBJECT };
+class StyledControl11 : public SCT::Control { Q_OBJECT };
+class StyledControl12 : public SCT::Control { Q_OBJECT };
+class StyledControl13 : public SCT::Control { Q_OBJECT };
+class StyledControl14 : public SCT::Control { Q_OBJECT };
+class StyledControl15 : public SCT::Control { Q_OBJECT };
+class StyledControl16 : public SCT::Control { Q_OBJECT };
+class StyledControl17 : public SCT::Control { Q_OBJECT };
+class StyledControl18 : public SCT::Control { Q_OBJECT };
+class StyledControl19 : public SCT::Control { Q_OBJECT };
+class StyledControl20 : public SCT::Control { Q_OBJECT };
+
+constexpr int maximumControlTypes{20};
+
+void registerControlTypes()
+{
+    const char *const uri = "Stoiridh.Controls.Benchmarks";
+
+    qmlRegisterType<StyledControl01>(uri, 1, 0, "Control01");
+    qmlRegisterType<StyledControl02>(uri, 1, 0, "Control02");
+    qmlRegisterType<StyledControl03>(uri, 1, 0, "Control03");
+    qmlRegisterType<StyledControl04>(uri, 1, 0, "Control04");
+    qmlRegisterType<StyledControl05>(uri, 1, 0, "Control05");
+    qmlRegisterType<StyledControl06>(uri, 1, 0, "Control06");
+    qmlRegisterType<StyledControl07>(uri, 1, 0, "Control07");
+    qmlRegisterType<StyledControl08>(uri, 1, 0, "Control08");
+    qmlRegisterType<StyledControl09>(uri, 1, 0, "Control09");
+    qmlRegisterType<StyledControl10>(uri, 1, 0, "Control10");
+    qmlRegisterType<StyledControl11>(uri, 1, 0, "Control11");
+    qmlRegisterType<StyledControl12>(uri, 1, 0, "Control12");
+    qmlRegisterType<StyledControl13>(uri, 1, 0, "Control13");
+    qmlRegisterType<StyledControl14>(uri, 1, 0, "Control14");
+    qmlRegisterType<StyledControl15>(uri, 1, 0, "Control15");
+    qmlRegisterType<StyledControl16>(uri, 1, 0, "Control16");
+    qmlRegisterType<StyledControl17>(uri, 1, 0, "Control17");
+    qmlRegisterType<StyledControl18>(uri, 1, 0, "Control18");
+    qmlRegisterType<StyledControl19>(uri, 1, 0, "Control19");
+    qmlRegisterType<StyledControl20>(uri, 1, 0, "Control20");
+}
+
+// generates the QML declaration of a styled control of the given type, with a default state and
+// `states - 1` named states.
+QByteArray generateControl(int index, int type, int states)
+{
+    QByteArray qml{};
+
+    qml += "    Control" + QByteArray::number(type + 1).rightJustified(2, '0') + " {\n";
+    qml += "        x: " + QByteArray::number((index % 100) * 12) + "\n";
+    qml += "        y: " + QByteArray::number((index / 100) * 12) + "\n";
+    qml += "        background: Rectangle { implicitWidth: 10; implicitHeight: 10 }\n";
+    qml += "        content: Item {}\n";
+    qml += "        style: Style {\n";
+
+    for (int state = 0; state < states; ++state)
+    {
+        const auto color = QByteArray::number(0x102030 + state * 0x080808 + type, 16);
+
+        qml += "            StyleState {\n";
+
+        if (state > 0)
+            qml += "                name: \"State" + QByteArray::number(state) + "\"\n";
+
+        qml += "                StylePropertyChanges {\n";
+        qml += "                    target: background\n";
+        qml += "                    color: \"#" + color + "\"\n";
+        qml += "                    opacity: " + QByteArray::number(1.0 - state * 0.05) + "\n";
+        qml += "                }\n";
+        qml += "            }\n";
+    }
+
+    qml += "        }\n";
+    qml += "    }\n";
+
+    return qml;
+}
+
+QByteArray generateScene(int controls, int types, int states)
+{
+    QByteArray qml{};
+    qml += "import QtQuick 2.6\n";
+    qml += "import Stoiridh.Controls.Private 1.0\n";
+    qml += "import Stoiridh.Controls.Benchmarks 1.0\n\n";
+    qml += "Item {\n";
+    qml += "    width: 1200\n";
+    qml += "    height: 1200\n";
+
+    for (int i = 0; i < controls; ++i)
+    {
+        qml += generateControl(i, i % types, states);
+    }
+
+    qml += "}\n";
+
+    return qml;
+}
+
+// returns the value, in kB, of a field of /proc/self/status, e.g. VmHWM for the peak resident set
+// size, or -1 if it is not available.
+qint64 processStatus(const QByteArray &field)
+{
+    QFile file{QStringLiteral("/proc/self/status")};
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return -1;
+
+    while (!file.atEnd())
+    {
+        const auto line = file.readLine();
+
+        if (line.startsWith(field + ':'))
+            return line.mid(field.size() + 1).trimmed().split(' ').first().toLongLong();
+    }
+
+    return -1;
+}
+
+// a scene loaded into its own engine and window, so that the StyleFactory starts empty.
+class Scene final
+{
+public:
+    Scene()
+    {
+        SCT::Bootstrap::QmlExtensionPlugin::init(&m_engine);
+
+        m_window.resize(1200, 1200);
+        m_window.show();
+    }
+
+    bool isExposed()
+    {
+        return QTest::qWaitForWindowExposed(&m_window);
+    }
+
+    bool compile(const QByteArray &qml)
+    {
+        m_component.reset(new QQmlComponent{&m_engine});
+        m_component->setData(qml, QUrl{QStringLiteral("file:///benchmarks/scene.qml")});
+
+        if (m_component->isError())
+            qWarning() << m_component->errors();
+
+        return m_component->isReady();
+    }
+
+    // returns the time elapsed, in nanoseconds, from the creation of the scene to its first frame.
+    qint64 load()
+    {
+        QSignalSpy frames{&m_window, &QQuickWindow::frameSwapped};
+
+        QElapsedTimer timer{};
+        timer.start();
+
+        auto *const root = qobject_cast<QQuickItem *>(m_component->create());
+
+        if (!root)
+            return -1;
+
+        root->setParentItem(m_window.contentItem());
+        m_window.update();
+
+        if (!frames.wait(60000))
+            return -1;
+
+        return timer.nsecsElapsed();
+    }
+
+    // creates the controls one by one, optionally without sharing the styles between them, and
+    // returns the time elapsed, in nanoseconds, until the first frame.
+    qint64 loadEach(const QByteArray &qml, int controls, bool shareStyles)
+    {
+        QQmlComponent component{&m_engine};
+        component.setData(qml, QUrl{QStringLiteral("file:///benchmarks/control.qml")});
+
+        if (!component.isReady())
+        {
+            qWarning() << component.errors();
+            return -1;
+        }
+
+        QSignalSpy frames{&m_window, &QQuickWindow::frameSwapped};
+
+        QElapsedTimer timer{};
+        timer.start();
+
+        for (int i = 0; i < controls; ++i)
+        {
+            // without sharing, each control creates its own style from scratch; the styles of the
+            // previous controls are released with the factory, which is harmless for the benchmark.
+            if (!shareStyles)
+                SCT::StyleFactory::destroy(&m_engine);
+
+            auto *const item = qobject_cast<QQuickItem *>(component.create());
+
+            if (!item)
+                return -1;
+
+            item->setParentItem(m_window.contentItem());
+        }
+
+        m_window.update();
+
+        if (!frames.wait(60000))
+            return -1;
+
+        return timer.nsecsElapsed();
+    }
+
+private:
+    QQmlEngine m_engine{};
+    QQuickWindow m_window{};
+    QScopedPointer<QQmlComponent> m_component{};
+};
+
+// loads the scene into its own engine, then returns the time elapsed, in nanoseconds, to destroy
+// the scene and its engine as the application does when restarting. The styles of the engine are
+// destroyed before the scene if `stylesFirst` is true, as the application does when quitting.
+qint64 teardown(const QByteArray &qml, bool stylesFirst, quint64 *allocations)
+{
+    QScopedPointer<QQmlEngine> engine{new QQmlEngine{}};
+    SCT::Bootstrap::QmlExtensionPlugin::init(engine.data());
+
+    // the component is destroyed with its engine.
+    auto *const component = new QQmlComponent{engine.data(), engine.data()};
+    component->setData(qml, QUrl{QStringLiteral("file:///benchmarks/scene.qml")});
+
+    QScopedPointer<QObject> root{component->create()};
+
+    if (!root)
+    {
+        qWarning() << component->errors();
+        return -1;
+    }
+
+    const auto count = benchmarkAllocations().load(std::memory_order_relaxed);
+
+    QElapsedTimer timer{};
+    timer.start();
+
+    if (stylesFirst)
+        SCT::StyleFactory::destroy(engine.data());
+
+    root.reset();
+    engine.reset();
+
+    const auto duration = timer.nsecsElapsed();
+
+    *allocations += benchmarkAllocations().load(std::memory_order_relaxed) - count;
+
+    return duration;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCase                                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class BenchmarkSCTQmlStartup : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void startup_data();
+    void startup();
+
+    void factorySharing_data();
+    void factorySharing();
+
+    void engineTeardown_data();
+    void engineTeardown();
+
+private:
+    BenchmarkHarness m_harness{QStringLiteral("bench_sct_qmlstartup")};
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Benchmarks                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void BenchmarkSCTQmlStartup::initTestCase()
+{
+    SCT::Bootstrap::QmlExtensionPlugin::qmlRegisterInternalTypes("Stoiridh.Controls.Private");
+    registerControlTypes();
+
+    // the recorder measures the share of Control::componentComplete and StyleFactory::create; the
+    // capacity must hold every event of the largest scene.
+    SCT::StyleTraceRecorder::setCapacity(1 << 20);
+    SCT::StyleTraceRecorder::setEnabled(true);
+}
+
+void BenchmarkSCTQmlStartup::cleanupTestCase()
+{
+    SCT::StyleTraceRecorder::setEnabled(false);
+
+    QString report{};
+    const bool ok = m_harness.finish(&report);
+
+    if (!report.isEmpty())
+        qDebug().noquote() << report;
+
+    QVERIFY2(ok, "The benchmarks have regressed against the baseline.");
+}
+
+void BenchmarkSCTQmlStartup::startup_data()
+{
+    QTest::addColumn<int>("controls");
+    QTest::addColumn<int>("types");
+    QTest::addColumn<int>("states");
+
+    for (const auto controls : {100, 1000, 10000})
+    {
+        for (const auto types : {1, maximumControlTypes})
+        {
+            for (const auto states : {2, 8})
+            {
+                const auto name = QStringLiteral("%1 controls, %2 types, %3 states").arg(controls)
+                                                                                     .arg(types)
+                                                                                     .arg(states);
+
+                QTest::newRow(qPrintable(name)) << controls << types << states;
+            }
+        }
+    }
+}
+
+void BenchmarkSCTQmlStartup::startup()
+{
+    QFETCH(int, controls);
+    QFETCH(int, types);
+    QFETCH(int, states);
+
+    const auto qml = generateScene(controls, types, states);
+    const int samples = controls >= 10000 ? 3 : 5;
+
+    QVector<qint64> durations{};
+    quint64 allocations{};
+    qint64 completeDuration{};
+    qint64 factoryDuration{};
+
+    for (int i = 0; i < samples; ++i)
+    {
+        Scene scene{};
+        QVERIFY(scene.isExposed());
+        QVERIFY(scene.compile(qml));
+
+        SCT::StyleTraceRecorder::clear();
+        const auto count = benchmarkAllocations().load(std::memory_order_relaxed);
+
+        const auto duration = scene.load();
+        QVERIFY(duration > 0);
+
+        allocations += benchmarkAllocations().load(std::memory_order_relaxed) - count;
+        durations.append(duration);
+
+        const auto trace = QJsonDocument::fromJson(SCT::StyleTraceRecorder::toJson()).object();
+        const auto events = trace.value(QStringLiteral("traceEvents")).toArray();
+
+        completeDuration += tracedDuration(events, QStringLiteral("Control::componentComplete"));
+        factoryDuration += tracedDuration(events, QStringLiteral("StyleFactory::create"));
+    }
+
+    const auto result = m_harness.record(QStringLiteral("startup %1")
+                                         .arg(QString::fromLatin1(QTest::currentDataTag())),
+                                         durations, allocations);
+
+    // the durations are summed over the samples, hence the share of the total time.
+    qint64 total{};
+
+    for (const auto duration : durations)
+    {
+        total += duration;
+    }
+
+    qDebug().noquote() << QStringLiteral("%1: first frame after %2 ms (p95 %3 ms), "
+                                         "componentComplete %4%, StyleFactory::create %5%, "
+                                         "peak RSS %6 kB")
+                          .arg(QString::fromLatin1(QTest::currentDataTag()))
+                          .arg(result.median / 1000000.0, 0, 'f', 2)
+                          .arg(result.p95 / 1000000.0, 0, 'f', 2)
+                          .arg(100.0 * completeDuration / total, 0, 'f', 1)
+                          .arg(100.0 * factoryDuration / total, 0, 'f', 1)
+                          .arg(processStatus("VmHWM"));
+
+    QTest::setBenchmarkResult(result.median / 1000000.0, QTest::WalltimeMilliseconds);
+}
+
+void BenchmarkSCTQmlStartup::factorySharing_data()
+{
+    QTest::addColumn<int>("controls");
+    QTest::addColumn<int>("states");
+
+    QTest::newRow("100 controls, 8 states")  << 100 << 8;
+    QTest::newRow("1000 controls, 8 states") << 1000 << 8;
+}
+
+void BenchmarkSCTQmlStartup::factorySharing()
+{
+    QFETCH(int, controls);
+    QFETCH(int, states);
+
+    QByteArray qml{};
+    qml += "import QtQuick 2.6\n";
+    qml += "import Stoiridh.Controls.Private 1.0\n";
+    qml += "import Stoiridh.Controls.Benchmarks 1.0\n\n";
+    qml += generateControl(0, 0, states);
+
+    QVector<qint64> shared{};
+    QVector<qint64> unique{};
+
+    for (int i = 0; i < 3; ++i)
+    {
+        for (const auto shareStyles : {true, false})
+        {
+            Scene scene{};
+            QVERIFY(scene.isExposed());
+
+            const auto duration = scene.loadEach(qml, controls, shareStyles);
+            QVERIFY(duration > 0);
+
+            (shareStyles ? shared : unique).append(duration);
+        }
+    }
+
+    const auto tag = QString::fromLatin1(QTest::currentDataTag());
+    const auto sharedResult = m_harness.record(QStringLiteral("shared %1").arg(tag), shared, 0);
+    const auto uniqueResult = m_harness.record(QStringLiteral("unique %1").arg(tag), unique, 0);
+
+    qDebug().noquote() << QStringLiteral("%1: type-shared %2 ms, every-control-unique %3 ms (x%4)")
+                          .arg(tag)
+                          .arg(sharedResult.median / 1000000.0, 0, 'f', 2)
+                          .arg(uniqueResult.median / 1000000.0, 0, 'f', 2)
+                          .arg(static_cast<double>(uniqueResult.median) / sharedResult.median,
+                               0, 'f', 2);
+
+    QTest::setBenchmarkResult(sharedResult.median / 1000000.0, QTest::WalltimeMilliseconds);
+}
+
+void BenchmarkSCTQmlStartup::engineTeardown_data()
+{
+    QTest::addColumn<int>("controls");
+    QTest::addColumn<int>("types");
+    QTest::addColumn<bool>("stylesFirst");
+
+    for (const auto controls : {1000, 10000})
+    {
+        for (const auto types : {1, maximumControlTypes})
+        {
+            const auto name = QStringLiteral("%1 controls, %2 types, %3 first").arg(controls)
+                                                                               .arg(types);
+
+            QTest::newRow(qPrintable(name.arg(QStringLiteral("scene"))))
+                    << controls << types << false;
+            QTest::newRow(qPrintable(name.arg(QStringLiteral("styles"))))
+                    << controls << types << true;
+        }
+    }
+}
+
+void BenchmarkSCTQmlStartup::engineTeardown()
+{
+    QFETCH(int, controls);
+    QFETCH(int, types);
+    QFETCH(bool, stylesFirst);
+
+    const auto qml = generateScene(controls, types, 8);
+
+    QVector<qint64> durations{};
+    quint64 allocations{};
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const auto duration = teardown(qml, stylesFirst, &allocations);
+
+        if (duration <= 0)
+            break;
+
+        durations.append(duration);
+    }
+
+    QCOMPARE(durations.count(), 3);
+
+    const auto result = m_harness.record(QStringLiteral("teardown %1")
+                                         .arg(QString::fromLatin1(QTest::currentDataTag())),
+                                         durations, allocations);
+
+    qDebug().noquote() << QStringLiteral("%1: engine destroyed in %2 ms (p95 %3 ms)")
+                          .arg(QString::fromLatin1(QTest::currentDataTag()))
+                          .arg(result.median / 1000000.0, 0, 'f', 2)
+                          .arg(result.p95 / 1000000.0, 0, 'f', 2);
+
+    QTest::setBenchmarkResult(result.median / 1000000.0, QTest::WalltimeMilliseconds);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Run                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char *argv[])
+{
+    // render off-screen unless a platform is requested, e.g., in order to use the GPU.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    // use the software renderer where it is available (Qt 5.8 or later).
+    if (qEnvironmentVariableIsEmpty("QT_QUICK_BACKEND"))
+        qputenv("QT_QUICK_BACKEND", "software");
+
+    QGuiApplication application{argc, argv};
+    BenchmarkSCTQmlStartup benchmark{};
+
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "tst_bench_sct_qmlstartup.moc"
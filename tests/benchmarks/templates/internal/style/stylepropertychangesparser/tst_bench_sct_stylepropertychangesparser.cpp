@@ -0,0 +1,233 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <QtTest>
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QScopedPointer>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+
+#include <StoiridhControlsTemplates/internal/diagnostics/styletracerecorder.hpp>
+#include <StoiridhControlsTemplates/private/bootstrap/qmlextensionplugin_p.hpp>
+
+#include <benchmarkharness.hpp>
+
+#include <numeric>
+
+namespace SCT = StoiridhControlsTemplates;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// generates a StylePropertyChanges of eight properties, half of them being group properties
+// (either nested or dotted).
+QByteArray generateChanges(int index)
+{
+    const auto color = QByteArray::number(0x102030 + index, 16).rightJustified(6, '0');
+    const auto number = QByteArray::number(index % 16);
+
+    QByteArray qml{};
+    qml += "                StylePropertyChanges {\n";
+    qml += "                    target: rectangle\n";
+    qml += "                    color: \"#" + color + "\"\n";
+    qml += "                    opacity: 0." + number + "\n";
+    qml += "                    radius: " + number + "\n";
+    qml += "                    visible: true\n";
+    qml += "                    border { width: " + number + "; color: \"#" + color + "\" }\n";
+    qml += "                    anchors.margins: " + number + "\n";
+    qml += "                    anchors.leftMargin: " + number + "\n";
+    qml += "                }\n";
+
+    return qml;
+}
+
+// generates a document whose style holds `properties` properties, spread over `states` states.
+QByteArray generateDocument(int properties, int states)
+{
+    constexpr int propertiesPerChanges{8};
+    const int changes = properties / propertiesPerChanges;
+
+    QByteArray qml{};
+    qml += "import QtQuick 2.6\n";
+    qml += "import Stoiridh.Controls.Private 1.0\n\n";
+    qml += "Item {\n";
+    qml += "    Rectangle { id: rectangle }\n\n";
+    qml += "    Style {\n";
+
+    for (int state = 0; state < states; ++state)
+    {
+        qml += "        StyleState {\n";
+        qml += "            name: \"State" + QByteArray::number(state) + "\"\n";
+
+        for (int i = state; i < changes; i += states)
+        {
+            qml += generateChanges(i);
+        }
+
+        qml += "        }\n";
+    }
+
+    qml += "    }\n";
+    qml += "}\n";
+
+    return qml;
+}
+
+QJsonArray tracedEvents()
+{
+    const auto trace = QJsonDocument::fromJson(SCT::StyleTraceRecorder::toJson()).object();
+    return trace.value(QStringLiteral("traceEvents")).toArray();
+}
+
+qint64 sum(const QVector<qint64> &durations)
+{
+    return std::accumulate(durations.cbegin(), durations.cend(), qint64{0});
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCase                                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class BenchmarkSCTStylePropertyChangesParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void compile_data();
+    void compile();
+
+private:
+    BenchmarkHarness m_harness{QStringLiteral("bench_sct_stylepropertychangesparser")};
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Benchmarks                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void BenchmarkSCTStylePropertyChangesParser::initTestCase()
+{
+    SCT::Bootstrap::QmlExtensionPlugin::qmlRegisterInternalTypes("Stoiridh.Controls.Private");
+
+    // the recorder isolates the parser from the rest of the QML compilation.
+    SCT::StyleTraceRecorder::setCapacity(1 << 16);
+    SCT::StyleTraceRecorder::setEnabled(true);
+}
+
+void BenchmarkSCTStylePropertyChangesParser::cleanupTestCase()
+{
+    SCT::StyleTraceRecorder::setEnabled(false);
+
+    QString report{};
+    const bool ok = m_harness.finish(&report);
+
+    if (!report.isEmpty())
+        qDebug().noquote() << report;
+
+    QVERIFY2(ok, "The benchmarks have regressed against the baseline.");
+}
+
+void BenchmarkSCTStylePropertyChangesParser::compile_data()
+{
+    QTest::addColumn<int>("properties");
+    QTest::addColumn<int>("states");
+
+    QTest::newRow("200 properties, 4 states")   << 200 << 4;
+    QTest::newRow("1000 properties, 8 states")  << 1000 << 8;
+    QTest::newRow("2000 properties, 8 states")  << 2000 << 8;
+    QTest::newRow("2000 properties, 32 states") << 2000 << 32;
+}
+
+void BenchmarkSCTStylePropertyChangesParser::compile()
+{
+    QFETCH(int, properties);
+    QFETCH(int, states);
+
+    const auto qml = generateDocument(properties, states);
+    constexpr int samples{10};
+
+    QVector<qint64> compilations{};
+    QVector<qint64> creations{};
+    QVector<qint64> verifications{};
+    QVector<qint64> applications{};
+    QVector<qint64> decodings{};
+
+    for (int i = 0; i < samples; ++i)
+    {
+        // a new engine does not hold the compilation unit of the previous sample.
+        QQmlEngine engine{};
+        SCT::Bootstrap::QmlExtensionPlugin::init(&engine);
+
+        QQmlComponent component{&engine};
+        SCT::StyleTraceRecorder::clear();
+
+        QElapsedTimer timer{};
+        timer.start();
+
+        component.setData(qml, QUrl{QStringLiteral("file:///benchmarks/style.qml")});
+        compilations.append(timer.nsecsElapsed());
+
+        if (!component.isReady())
+            qWarning() << component.errors();
+
+        QVERIFY(component.isReady());
+        verifications.append(tracedDuration(tracedEvents(),
+                                            QStringLiteral("StylePropertyChangesParser::"
+                                                           "verifyBindings")));
+
+        SCT::StyleTraceRecorder::clear();
+        timer.restart();
+
+        QScopedPointer<QObject> object{component.create()};
+        creations.append(timer.nsecsElapsed());
+        QVERIFY(object);
+
+        const auto events = tracedEvents();
+        applications.append(tracedDuration(events, QStringLiteral("StylePropertyChangesParser::"
+                                                                  "applyBindings")));
+        decodings.append(tracedDuration(events, QStringLiteral("StylePropertyChangesPrivate::"
+                                                               "decodeGroupPropertyBindings")));
+    }
+
+    const auto tag = QString::fromLatin1(QTest::currentDataTag());
+    const auto compilation = m_harness.record(QStringLiteral("compile %1").arg(tag),
+                                              compilations, 0);
+    const auto creation = m_harness.record(QStringLiteral("create %1").arg(tag), creations, 0);
+
+    m_harness.record(QStringLiteral("verifyBindings %1").arg(tag), verifications, 0);
+    m_harness.record(QStringLiteral("applyBindings %1").arg(tag), applications, 0);
+    m_harness.record(QStringLiteral("decodeGroupPropertyBindings %1").arg(tag), decodings, 0);
+
+    qDebug().noquote() << QStringLiteral("%1: compile %2 ms (verifyBindings %3%), "
+                                         "create %4 ms (applyBindings %5%, "
+                                         "decodeGroupPropertyBindings %6%)")
+                          .arg(tag)
+                          .arg(compilation.median / 1000000.0, 0, 'f', 2)
+                          .arg(100.0 * sum(verifications) / sum(compilations), 0, 'f', 1)
+                          .arg(creation.median / 1000000.0, 0, 'f', 2)
+                          .arg(100.0 * sum(applications) / sum(creations), 0, 'f', 1)
+                          .arg(100.0 * sum(decodings) / sum(creations), 0, 'f', 1);
+
+    QTest::setBenchmarkResult(compilation.median / 1000000.0, QTest::WalltimeMilliseconds);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Run                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QTEST_MAIN(BenchmarkSCTStylePropertyChangesParser)
+#include "tst_bench_sct_stylepropertychangesparser.moc"
@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <QtTest>
+
+#include <QtCore/QSharedPointer>
+#include <QtQuick/QQuickItem>
+
+#include <StoiridhControlsTemplates/Control>
+
+#include <StoiridhControlsTemplates/internal/style/style.hpp>
+#include <StoiridhControlsTemplates/internal/style/stylepropertyexpression.hpp>
+#include <StoiridhControlsTemplates/internal/style/stylestatecontroller.hpp>
+#include <StoiridhControlsTemplates/internal/style/stylestateoperation.hpp>
+
+#include <benchmarkharness.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace SCT = StoiridhControlsTemplates;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// a style state controller holding a default operation of two expressions, one for the background
+// and one for the content, mapped to `count` controls.
+class StyleFixture final
+{
+public:
+    explicit StyleFixture(int count)
+        : m_style{new SCT::Style{}}
+        , m_controller{new SCT::StyleStateController{m_style.get()}}
+    {
+        auto background = QSharedPointer<SCT::StylePropertyExpression>::create();
+        background->addProperty(QStringLiteral("width"), 75.0);
+        background->addProperty(QStringLiteral("height"), 25.0);
+        background->addProperty(QStringLiteral("opacity"), 0.5);
+
+        auto content = QSharedPointer<SCT::StylePropertyExpression>::create();
+        content->addProperty(QStringLiteral("width"), 64.0);
+        content->addProperty(QStringLiteral("height"), 16.0);
+
+        m_controls.reserve(static_cast<std::size_t>(count));
+
+        for (int i = 0; i < count; ++i)
+        {
+            auto *const control = new SCT::Control{};
+            control->setParent(&m_root);
+            control->setBackground(new QQuickItem{control});
+            control->setContent(new QQuickItem{control});
+
+            background->addMapping(control, control->background());
+            content->addMapping(control, control->content());
+
+            m_controls.push_back(control);
+        }
+
+        auto operation = QSharedPointer<SCT::StyleStateOperation>::create();
+        operation->addExpression(std::move(background));
+        operation->addExpression(std::move(content));
+
+        m_controller->addStateOperation(std::move(operation));
+    }
+
+    int apply()
+    {
+        int writes{};
+
+        for (const auto *control : m_controls)
+        {
+            writes += m_controller->apply(control);
+        }
+
+        return writes;
+    }
+
+private:
+    QObject m_root{};
+    std::unique_ptr<SCT::Style> m_style{};
+    std::unique_ptr<SCT::StyleStateController> m_controller{};
+    std::vector<SCT::Control *> m_controls{};
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCase                                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class BenchmarkSCTStyleStateController : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanupTestCase();
+
+    void apply_data();
+    void apply();
+
+private:
+    BenchmarkHarness m_harness{QStringLiteral("bench_sct_stylestatecontroller")};
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Benchmarks                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void BenchmarkSCTStyleStateController::cleanupTestCase()
+{
+    QString report{};
+    const bool ok = m_harness.finish(&report);
+
+    if (!report.isEmpty())
+        qDebug().noquote() << report;
+
+    QVERIFY2(ok, "The benchmarks have regressed against the baseline.");
+}
+
+void BenchmarkSCTStyleStateController::apply_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1 control")       << 1;
+    QTest::newRow("100 controls")    << 100;
+    QTest::newRow("10000 controls")  << 10000;
+}
+
+void BenchmarkSCTStyleStateController::apply()
+{
+    QFETCH(int, count);
+
+    StyleFixture fixture{count};
+    QCOMPARE(fixture.apply(), count * 5);
+
+    QBENCHMARK
+    {
+        fixture.apply();
+    }
+
+    m_harness.measure(QStringLiteral("apply %1").arg(QString::fromLatin1(QTest::currentDataTag())),
+                      31, [&fixture]() { fixture.apply(); });
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Run                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QTEST_APPLESS_MAIN(BenchmarkSCTStyleStateController)
+#include "tst_bench_sct_stylestatecontroller.moc"
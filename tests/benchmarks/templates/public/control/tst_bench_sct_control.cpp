@@ -0,0 +1,341 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                //
+//            Copyright (C) 2016 William McKIE                                                    //
+//                                                                                                //
+//            This program is free software: you can redistribute it and/or modify                //
+//            it under the terms of the GNU General Public License as published by                //
+//            the Free Software Foundation, either version 3 of the License, or                   //
+//            (at your option) any later version.                                                 //
+//                                                                                                //
+//            This program is distributed in the hope that it will be useful,                     //
+//            but WITHOUT ANY WARRANTY; without even the implied warranty of                      //
+//            MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                       //
+//            GNU General Public License for more details.                                        //
+//                                                                                                //
+//            You should have received a copy of the GNU General Public License                   //
+//            along with this program.  If not, see <http://www.gnu.org/licenses/>.               //
+//                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <QtTest>
+
+#include <QtQuick/QQuickItem>
+
+#include <StoiridhControlsTemplates/Control>
+
+#include <benchmarkharness.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace SCT = StoiridhControlsTemplates;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Helpers                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class BenchmarkControl final : public SCT::Control
+{
+public:
+    using SCT::Control::Control;
+
+    // exposes the QQmlParserStatus interface in order to mimic the QML engine.
+    using SCT::Control::classBegin;
+    using SCT::Control::componentComplete;
+
+    static quint64 geometryChanges;
+
+protected:
+    void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override
+    {
+        ++geometryChanges;
+        SCT::Control::geometryChanged(newGeometry, oldGeometry);
+    }
+};
+
+quint64 BenchmarkControl::geometryChanges{0};
+
+// a tree of controls is compounded of chains of controls where each control of a chain is the
+// content item of its predecessor. A depth of 1 corresponds to a flat tree.
+class ControlTree final
+{
+public:
+    ControlTree(int count, int depth)
+        : m_root{new QQuickItem{}}
+    {
+        m_controls.reserve(static_cast<std::size_t>(count));
+
+        for (auto i = 0; i < count; i += depth)
+        {
+            BenchmarkControl *parent{nullptr};
+
+            for (auto j = 0; j < depth && (i + j) < count; ++j)
+            {
+                auto *const control = new BenchmarkControl{};
+                control->setParent(m_root.get());
+                control->classBegin();
+
+                auto *const background = new QQuickItem{m_root.get()};
+                background->setImplicitSize(100.0, 40.0);
+                control->setBackground(background);
+
+                if (parent)
+                {
+                    parent->setContent(control);
+                }
+                else
+                {
+                    control->setParentItem(m_root.get());
+
+                    // the last control of a chain holds a simple content item.
+                    auto *const content = new QQuickItem{m_root.get()};
+                    content->setImplicitSize(80.0, 20.0);
+                    control->setContent(content);
+                }
+
+                m_controls.push_back(control);
+                parent = control;
+            }
+
+            m_roots.push_back(m_controls.at(static_cast<std::size_t>(i)));
+        }
+    }
+
+    int count() const
+    {
+        return static_cast<int>(m_controls.size());
+    }
+
+    // completes the controls from the deepest to the shallowest, as the QML engine does.
+    void complete()
+    {
+        for (auto it = m_controls.rbegin(); it != m_controls.rend(); ++it)
+        {
+            (*it)->componentComplete();
+        }
+    }
+
+    void resize(qreal width, qreal height)
+    {
+        for (auto *const control : m_roots)
+        {
+            control->setSize(QSizeF{width, height});
+        }
+    }
+
+    void setPaddings(qreal paddings)
+    {
+        for (auto *const control : m_controls)
+        {
+            control->setPaddings(paddings);
+        }
+    }
+
+private:
+    std::unique_ptr<QQuickItem> m_root{};
+    std::vector<BenchmarkControl *> m_controls{};
+    std::vector<BenchmarkControl *> m_roots{};
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  TestCase                                                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class BenchmarkSCTControl : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Operation { Complete, Resize, Paddings };
+
+private:
+    static void addTreeRows();
+    static QString resultName(const char *benchmark);
+
+private slots:
+    void cleanupTestCase();
+
+    void componentComplete_data();
+    void componentComplete();
+
+    void resize_data();
+    void resize();
+
+    void paddings_data();
+    void paddings();
+
+    void geometryChanges_data();
+    void geometryChanges();
+
+private:
+    BenchmarkHarness m_harness{QStringLiteral("bench_sct_control")};
+};
+
+Q_DECLARE_METATYPE(BenchmarkSCTControl::Operation)
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Data                                                                                          //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void BenchmarkSCTControl::addTreeRows()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("depth");
+
+    for (const auto count : {1000, 10000, 100000})
+    {
+        QTest::newRow(qPrintable(QStringLiteral("Flat %1").arg(count)))      << count << 1;
+        QTest::newRow(qPrintable(QStringLiteral("Nested-16 %1").arg(count))) << count << 16;
+        QTest::newRow(qPrintable(QStringLiteral("Nested-256 %1").arg(count))) << count << 256;
+    }
+}
+
+QString BenchmarkSCTControl::resultName(const char *benchmark)
+{
+    return QStringLiteral("%1 %2").arg(QString::fromLatin1(benchmark))
+                                  .arg(QString::fromLatin1(QTest::currentDataTag()));
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Benchmarks                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void BenchmarkSCTControl::cleanupTestCase()
+{
+    QString report{};
+    const bool ok = m_harness.finish(&report);
+
+    if (!report.isEmpty())
+        qDebug().noquote() << report;
+
+    QVERIFY2(ok, "The benchmarks have regressed against the baseline.");
+}
+
+void BenchmarkSCTControl::componentComplete_data()
+{
+    addTreeRows();
+}
+
+void BenchmarkSCTControl::componentComplete()
+{
+    QFETCH(int, count);
+    QFETCH(int, depth);
+
+    ControlTree tree{count, depth};
+
+    QBENCHMARK_ONCE
+    {
+        tree.complete();
+    }
+}
+
+void BenchmarkSCTControl::resize_data()
+{
+    addTreeRows();
+}
+
+void BenchmarkSCTControl::resize()
+{
+    QFETCH(int, count);
+    QFETCH(int, depth);
+
+    ControlTree tree{count, depth};
+    tree.complete();
+
+    bool toggle{false};
+
+    QBENCHMARK
+    {
+        toggle = !toggle;
+        toggle ? tree.resize(640.0, 480.0) : tree.resize(320.0, 240.0);
+    }
+
+    m_harness.measure(resultName("resize"), 15, [&tree, &toggle]() {
+        toggle = !toggle;
+        toggle ? tree.resize(640.0, 480.0) : tree.resize(320.0, 240.0);
+    });
+}
+
+void BenchmarkSCTControl::paddings_data()
+{
+    addTreeRows();
+}
+
+void BenchmarkSCTControl::paddings()
+{
+    QFETCH(int, count);
+    QFETCH(int, depth);
+
+    ControlTree tree{count, depth};
+    tree.complete();
+
+    bool toggle{false};
+
+    QBENCHMARK
+    {
+        toggle = !toggle;
+        tree.setPaddings(toggle ? 4.0 : 8.0);
+    }
+
+    m_harness.measure(resultName("paddings"), 15, [&tree, &toggle]() {
+        toggle = !toggle;
+        tree.setPaddings(toggle ? 4.0 : 8.0);
+    });
+}
+
+void BenchmarkSCTControl::geometryChanges_data()
+{
+    QTest::addColumn<Operation>("operation");
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("depth");
+
+    const QVector<QPair<QString, Operation>> operations{
+        {QStringLiteral("Complete"), Operation::Complete},
+        {QStringLiteral("Resize"), Operation::Resize},
+        {QStringLiteral("Paddings"), Operation::Paddings}
+    };
+
+    for (const auto &operation : operations)
+    {
+        for (const auto count : {1000, 10000, 100000})
+        {
+            for (const auto depth : {1, 16, 256})
+            {
+                const auto name = QStringLiteral("%1 Depth-%2 %3").arg(operation.first)
+                                                                  .arg(depth)
+                                                                  .arg(count);
+
+                QTest::newRow(qPrintable(name)) << operation.second << count << depth;
+            }
+        }
+    }
+}
+
+void BenchmarkSCTControl::geometryChanges()
+{
+    QFETCH(Operation, operation);
+    QFETCH(int, count);
+    QFETCH(int, depth);
+
+    ControlTree tree{count, depth};
+
+    if (operation != Operation::Complete)
+        tree.complete();
+
+    BenchmarkControl::geometryChanges = 0;
+
+    switch (operation)
+    {
+    case Operation::Complete:
+        tree.complete();
+        break;
+    case Operation::Resize:
+        tree.resize(640.0, 480.0);
+        break;
+    case Operation::Paddings:
+        tree.setPaddings(4.0);
+        break;
+    }
+
+    // reports the number of geometryChanged() calls per control, a linear layout must keep this
+    // value constant whatever the number of controls.
+    const auto changes = static_cast<qreal>(BenchmarkControl::geometryChanges) / tree.count();
+    QTest::setBenchmarkResult(changes, QTest::Events);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Run                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////
+QTEST_APPLESS_MAIN(BenchmarkSCTControl)
+#include "tst_bench_sct_control.moc"